@@ -0,0 +1,31 @@
+#include "CF_Waypoint.h"
+
+// # Engine Includes
+#include "Engine/World.h"
+
+// # Project Includes
+#include "VHS_Project.h"
+#include "AI/CF_WaypointSubsystem.h"
+
+ACF_Waypoint::ACF_Waypoint()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	SetRootComponent(CreateDefaultSubobject<USceneComponent>("Scene"));
+}
+
+void ACF_Waypoint::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (auto* waypoints = GetWorld()->GetSubsystem<UCF_WaypointSubsystem>())
+		waypoints->AddWaypoint(this);
+}
+
+void ACF_Waypoint::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (auto* waypoints = GetWorld()->GetSubsystem<UCF_WaypointSubsystem>())
+		waypoints->RemoveWaypoint(this);
+
+	Super::EndPlay(EndPlayReason);
+}
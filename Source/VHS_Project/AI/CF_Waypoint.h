@@ -0,0 +1,43 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+
+#include "CF_Waypoint.generated.h"
+
+/**
+ * Native base of BP_Waypoint. Links are authored per instance, UCF_WaypointSubsystem turns the placed waypoints
+ * into the roaming graph once their level is loaded.
+ */
+UCLASS()
+class VHS_PROJECT_API ACF_Waypoint : public AActor
+{
+	GENERATED_BODY()
+
+public:
+
+	ACF_Waypoint();
+
+	UPROPERTY(EditInstanceOnly, BlueprintReadOnly, Category = "CustomProperties | Waypoint")
+	TArray<ACF_Waypoint*> Links;
+
+	/** Links are walked both ways unless set */
+	UPROPERTY(EditInstanceOnly, BlueprintReadOnly, Category = "CustomProperties | Waypoint")
+	bool bOneWay = false;
+
+	/** Relative chance of being picked as the next roaming waypoint */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "CustomProperties | Waypoint", meta = (ClampMin = "0"))
+	float RoamWeight = 1.f;
+
+	int32 GetGraphIndex() const { return GraphIndex; }
+
+	void SetGraphIndex(const int32 Index) { GraphIndex = Index; }
+
+protected:
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	int32 GraphIndex = INDEX_NONE;
+};
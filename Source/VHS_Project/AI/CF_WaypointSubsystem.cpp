@@ -0,0 +1,332 @@
+#include "CF_WaypointSubsystem.h"
+
+// # Engine Includes
+#include "AIController.h"
+#include "Engine/World.h"
+#include "NavigationSystem.h"
+#include "NavMesh/NavMeshPath.h"
+#include "TimerManager.h"
+
+// # Project Includes
+#include "VHS_Project.h"
+#include "AI/CF_Waypoint.h"
+#include "Subsystems/CF_RandomSubsystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("Waypoint Graph Build"), STAT_VHS_WaypointGraphBuild, STATGROUP_VHS);
+
+void UCF_WaypointSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Stream = UCF_RandomSubsystem::MakeStreamFor(this, TEXT("Waypoints"));
+}
+
+void UCF_WaypointSubsystem::Deinitialize()
+{
+	if (auto* world = GetWorld())
+		world->GetTimerManager().ClearTimer(TH_Rebuild);
+
+	// Queries still in flight are ignored by their build id
+	++BuildId;
+	Waypoints.Empty();
+	Edges.Empty();
+	OutEdges.Empty();
+	NextEdges.Empty();
+
+	Super::Deinitialize();
+}
+
+void UCF_WaypointSubsystem::AddWaypoint(ACF_Waypoint* Waypoint)
+{
+	if (!Waypoint || Waypoints.Contains(Waypoint))
+		return;
+
+	Waypoints.Add(Waypoint);
+
+	// The tables are sized for the old set, and a build in flight must not finish against the new one
+	++BuildId;
+	PendingQueries = 0;
+	bIsReady = false;
+
+	Retries = 0;
+	ScheduleRebuild(RebuildDelay);
+}
+
+void UCF_WaypointSubsystem::RemoveWaypoint(ACF_Waypoint* Waypoint)
+{
+	if (!Waypoint || Waypoints.Remove(Waypoint) == 0)
+		return;
+
+	// Indices shift, nothing can be looked up until the next build and a build in flight is dropped
+	Waypoint->SetGraphIndex(INDEX_NONE);
+	++BuildId;
+	PendingQueries = 0;
+	bIsReady = false;
+
+	if (!GetWorld()->bIsTearingDown)
+		ScheduleRebuild(RebuildDelay);
+}
+
+ACF_Waypoint* UCF_WaypointSubsystem::GetNextHop(const ACF_Waypoint* From, const ACF_Waypoint* To) const
+{
+	const int32 edge = GetNextEdge(From, To);
+	return edge != INDEX_NONE ? Waypoints[Edges[edge].To].Get() : nullptr;
+}
+
+ACF_Waypoint* UCF_WaypointSubsystem::PickNextWaypoint(const ACF_Waypoint* From, const ACF_Waypoint* Previous)
+{
+	const int32 from = From ? From->GetGraphIndex() : INDEX_NONE;
+	if (!bIsReady || !OutEdges.IsValidIndex(from))
+		return nullptr;
+
+	TArray<TPair<ACF_Waypoint*, float>, TInlineAllocator<8>> candidates;
+	float totalWeight = 0.f;
+
+	for (const int32 edgeIdx : OutEdges[from])
+	{
+		const FWaypointEdge& edge = Edges[edgeIdx];
+		ACF_Waypoint* waypoint = Waypoints[edge.To].Get();
+		if (edge.Cost < 0.f || !waypoint || waypoint->RoamWeight <= 0.f)
+			continue;
+
+		candidates.Emplace(waypoint, waypoint->RoamWeight);
+		if (waypoint != Previous)
+			totalWeight += waypoint->RoamWeight;
+	}
+
+	// Dead end, going back is the only way
+	const bool bAllowPrevious = totalWeight <= 0.f;
+	if (bAllowPrevious)
+	{
+		for (const auto& candidate : candidates)
+			totalWeight += candidate.Value;
+	}
+
+	ACF_Waypoint* last = nullptr;
+	float roll = Stream.FRand() * totalWeight;
+	for (const auto& candidate : candidates)
+	{
+		if (candidate.Key == Previous && !bAllowPrevious)
+			continue;
+
+		last = candidate.Key;
+		roll -= candidate.Value;
+		if (roll < 0.f)
+			return candidate.Key;
+	}
+
+	// Float rounding can leave a sliver of the roll past the last candidate
+	return last;
+}
+
+ACF_Waypoint* UCF_WaypointSubsystem::FindNearestWaypoint(const FVector& Location) const
+{
+	ACF_Waypoint* nearest = nullptr;
+	float nearestDistSq = MAX_flt;
+
+	for (const auto& waypoint : Waypoints)
+	{
+		if (!waypoint.IsValid())
+			continue;
+
+		const float distSq = FVector::DistSquared(waypoint->GetActorLocation(), Location);
+		if (distSq < nearestDistSq)
+		{
+			nearestDistSq = distSq;
+			nearest = waypoint.Get();
+		}
+	}
+
+	return nearest;
+}
+
+bool UCF_WaypointSubsystem::MoveToNextHop(AAIController* Controller, const ACF_Waypoint* From, const ACF_Waypoint* To, ACF_Waypoint*& OutNextHop, const float AcceptanceRadius)
+{
+	OutNextHop = nullptr;
+
+	const int32 edgeIdx = GetNextEdge(From, To);
+	if (!Controller || edgeIdx == INDEX_NONE)
+		return false;
+
+	const FWaypointEdge& edge = Edges[edgeIdx];
+	ACF_Waypoint* nextHop = Waypoints[edge.To].Get();
+	if (!nextHop || !edge.Path.IsValid())
+		return false;
+
+	FAIMoveRequest request(nextHop->GetActorLocation());
+	request.SetAcceptanceRadius(AcceptanceRadius);
+
+	// Path following observes and repaths the path it's given, every move gets its own copy of the cached points
+	TSharedRef<FNavMeshPath> path = MakeShared<FNavMeshPath>();
+	path->GetPathPoints() = edge.Path->GetPathPoints();
+	path->SetNavigationDataUsed(edge.Path->GetNavigationDataUsed());
+	path->SetQuerier(Controller);
+	path->MarkReady();
+
+	if (!Controller->RequestMove(request, path).IsValid())
+		return false;
+
+	OutNextHop = nextHop;
+	return true;
+}
+
+void UCF_WaypointSubsystem::ScheduleRebuild(const float Delay)
+{
+	if (auto* world = GetWorld())
+		world->GetTimerManager().SetTimer(TH_Rebuild, this, &UCF_WaypointSubsystem::Rebuild, Delay, false);
+}
+
+void UCF_WaypointSubsystem::Rebuild()
+{
+	++BuildId;
+	bIsReady = false;
+	PendingQueries = 0;
+	FailedQueries = 0;
+
+	Waypoints.RemoveAll([](const TWeakObjectPtr<ACF_Waypoint>& waypoint) { return !waypoint.IsValid(); });
+
+	const int32 num = Waypoints.Num();
+	for (int32 i = 0; i < num; ++i)
+		Waypoints[i]->SetGraphIndex(i);
+
+	Edges.Reset();
+	OutEdges.Reset();
+	OutEdges.SetNum(num);
+	NextEdges.Reset();
+
+	auto addEdge = [this](const int32 From, const int32 To)
+	{
+		if (From == To || OutEdges[From].ContainsByPredicate([this, To](const int32 edgeIdx) { return Edges[edgeIdx].To == To; }))
+			return;
+
+		FWaypointEdge& edge = Edges.AddDefaulted_GetRef();
+		edge.From = From;
+		edge.To = To;
+		OutEdges[From].Add(Edges.Num() - 1);
+	};
+
+	for (int32 i = 0; i < num; ++i)
+	{
+		const ACF_Waypoint* waypoint = Waypoints[i].Get();
+		for (const ACF_Waypoint* link : waypoint->Links)
+		{
+			// Links into a level that isn't loaded are left out until it is
+			const int32 j = link ? link->GetGraphIndex() : INDEX_NONE;
+			if (!Waypoints.IsValidIndex(j) || Waypoints[j].Get() != link)
+				continue;
+
+			addEdge(i, j);
+			if (!waypoint->bOneWay)
+				addEdge(j, i);
+		}
+	}
+
+	auto* navSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	const ANavigationData* navData = navSys ? navSys->GetDefaultNavDataInstance(FNavigationSystem::DontCreate) : nullptr;
+	if (!navData)
+	{
+		if (Retries++ < MaxRetries)
+			ScheduleRebuild(RetryDelay);
+		return;
+	}
+
+	// One query per link, answered off the game thread by the navigation system
+	for (int32 e = 0; e < Edges.Num(); ++e)
+	{
+		const FWaypointEdge& edge = Edges[e];
+		const FPathFindingQuery query(this, *navData, Waypoints[edge.From]->GetActorLocation(), Waypoints[edge.To]->GetActorLocation());
+
+		navSys->FindPathAsync(navData->GetConfig(), query, FNavPathQueryDelegate::CreateUObject(this, &UCF_WaypointSubsystem::HandlePathFound, BuildId, e));
+		++PendingQueries;
+	}
+
+	if (PendingQueries == 0)
+		FinishBuild();
+}
+
+void UCF_WaypointSubsystem::HandlePathFound(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path, int32 InBuildId, int32 EdgeIdx)
+{
+	if (InBuildId != BuildId || !Edges.IsValidIndex(EdgeIdx))
+		return;
+
+	FWaypointEdge& edge = Edges[EdgeIdx];
+	if (Result == ENavigationQueryResult::Success && Path.IsValid() && Path->IsValid() && !Path->IsPartial())
+	{
+		edge.Path = Path;
+		edge.Cost = Path->GetLength();
+	}
+	else
+		++FailedQueries;
+
+	if (--PendingQueries == 0)
+		FinishBuild();
+}
+
+void UCF_WaypointSubsystem::FinishBuild()
+{
+	VHS_SCOPE(WaypointGraphBuild);
+
+	const int32 num = Waypoints.Num();
+
+	TArray<float> dist;
+	dist.Init(MAX_flt, num * num);
+	NextEdges.Init(INDEX_NONE, num * num);
+
+	for (int32 i = 0; i < num; ++i)
+		dist[i * num + i] = 0.f;
+
+	for (int32 e = 0; e < Edges.Num(); ++e)
+	{
+		const FWaypointEdge& edge = Edges[e];
+		const int32 idx = edge.From * num + edge.To;
+		if (edge.Cost >= 0.f && edge.Cost < dist[idx])
+		{
+			dist[idx] = edge.Cost;
+			NextEdges[idx] = e;
+		}
+	}
+
+	// Floyd-Warshall, a level holds tens of waypoints and this only runs when one streams in
+	for (int32 k = 0; k < num; ++k)
+	{
+		for (int32 i = 0; i < num; ++i)
+		{
+			const float distIK = dist[i * num + k];
+			if (distIK == MAX_flt)
+				continue;
+
+			for (int32 j = 0; j < num; ++j)
+			{
+				const float distKJ = dist[k * num + j];
+				if (distKJ != MAX_flt && distIK + distKJ < dist[i * num + j])
+				{
+					dist[i * num + j] = distIK + distKJ;
+					NextEdges[i * num + j] = NextEdges[i * num + k];
+				}
+			}
+		}
+	}
+
+	bIsReady = true;
+
+	UE_LOG(LogVHS, Log, TEXT("Waypoints: %d waypoints, %d of %d links with a path"), num, Edges.Num() - FailedQueries, Edges.Num());
+
+	OnGraphReady.Broadcast();
+
+	if (FailedQueries > 0 && Retries++ < MaxRetries)
+		ScheduleRebuild(RetryDelay);
+}
+
+int32 UCF_WaypointSubsystem::GetNextEdge(const ACF_Waypoint* From, const ACF_Waypoint* To) const
+{
+	if (!bIsReady || !From || !To)
+		return INDEX_NONE;
+
+	const int32 num = Waypoints.Num();
+	const int32 from = From->GetGraphIndex();
+	const int32 to = To->GetGraphIndex();
+	if (!Waypoints.IsValidIndex(from) || !Waypoints.IsValidIndex(to) || from == to)
+		return INDEX_NONE;
+
+	return NextEdges[from * num + to];
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NavigationData.h"
+
+#include "Utils/CF_RandomStream.h"
+
+#include "CF_WaypointSubsystem.generated.h"
+
+// # Engine Forwards
+class AAIController;
+
+// # Project Forwards
+class ACF_Waypoint;
+
+DECLARE_MULTICAST_DELEGATE(FOnWaypointGraphReady)
+
+/**
+ * Roaming graph of the placed ACF_Waypoints. When waypoints come in with their level, the navmesh path of every
+ * link is found once with async queries and kept, and an all-pairs next hop table is built from the path lengths.
+ * Roaming then never queries the navmesh: the next hop towards any waypoint is a table lookup and the move
+ * follows a copy of the stored path. Ghosts only pathfind when they leave the graph to chase the player.
+ */
+UCLASS()
+class VHS_PROJECT_API UCF_WaypointSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	/** Fired every time a build completes */
+	FOnWaypointGraphReady OnGraphReady;
+
+	void AddWaypoint(ACF_Waypoint* Waypoint);
+
+	void RemoveWaypoint(ACF_Waypoint* Waypoint);
+
+	UFUNCTION(BlueprintPure, Category = "Waypoints")
+	bool IsGraphReady() const { return bIsReady; }
+
+	/** First waypoint on the shortest route, null if To can't be reached */
+	UFUNCTION(BlueprintPure, Category = "Waypoints")
+	ACF_Waypoint* GetNextHop(const ACF_Waypoint* From, const ACF_Waypoint* To) const;
+
+	/** Linked waypoint picked by RoamWeight, Previous is only picked again at a dead end */
+	UFUNCTION(BlueprintCallable, Category = "Waypoints")
+	ACF_Waypoint* PickNextWaypoint(const ACF_Waypoint* From, const ACF_Waypoint* Previous = nullptr);
+
+	/** Where a ghost rejoins the graph after a chase */
+	UFUNCTION(BlueprintPure, Category = "Waypoints")
+	ACF_Waypoint* FindNearestWaypoint(const FVector& Location) const;
+
+	/**
+	 * Moves Controller to the next hop from From towards To along the stored path, no navmesh query is made.
+	 * False if the graph isn't ready or there's no route, the caller falls back to a regular move.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Waypoints")
+	bool MoveToNextHop(AAIController* Controller, const ACF_Waypoint* From, const ACF_Waypoint* To, ACF_Waypoint*& OutNextHop, const float AcceptanceRadius = 50.f);
+
+protected:
+
+	/** Waypoints of a level register over a few frames, the build waits for them to settle */
+	float RebuildDelay = .5f;
+
+	/** Links without a path are retried this long after a build, the navmesh of a level may register late */
+	float RetryDelay = 2.f;
+	int32 MaxRetries = 3;
+
+	struct FWaypointEdge
+	{
+		int32 From = INDEX_NONE;
+		int32 To = INDEX_NONE;
+		float Cost = -1.f;
+		FNavPathSharedPtr Path;
+	};
+
+	TArray<TWeakObjectPtr<ACF_Waypoint>> Waypoints;
+	TArray<FWaypointEdge> Edges;
+	TArray<TArray<int32>> OutEdges;
+
+	/** [From * Num + To] edge of the first hop, INDEX_NONE when unreachable */
+	TArray<int32> NextEdges;
+
+	int32 BuildId = 0;
+	int32 PendingQueries = 0;
+	int32 FailedQueries = 0;
+	int32 Retries = 0;
+	bool bIsReady = false;
+
+	FTimerHandle TH_Rebuild;
+
+	FCF_RandomStream Stream;
+
+	// -------------------------------------------------------------------------
+
+	void ScheduleRebuild(const float Delay);
+
+	void Rebuild();
+
+	void HandlePathFound(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path, int32 InBuildId, int32 EdgeIdx);
+
+	void FinishBuild();
+
+	int32 GetNextEdge(const ACF_Waypoint* From, const ACF_Waypoint* To) const;
+};
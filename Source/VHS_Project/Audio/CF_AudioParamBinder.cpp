@@ -0,0 +1,133 @@
+#include "CF_AudioParamBinder.h"
+
+// # Engine Includes
+#include "Components/AudioComponent.h"
+
+// # Project Includes
+#include "VHS_Project.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Audio Commands Issued"), STAT_VHS_AudioCommandsIssued, STATGROUP_VHS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Audio Commands Skipped"), STAT_VHS_AudioCommandsSkipped, STATGROUP_VHS);
+DECLARE_CYCLE_STAT(TEXT("Audio Param Flush"), STAT_VHS_AudioParamFlush, STATGROUP_VHS);
+
+void FCF_AudioParamBinder::Setup(UAudioComponent* inAudio)
+{
+	Audio = inAudio;
+
+	// Everything is resent to the new component
+	for (FParam& param : Params)
+		param.bHasBeenSent = false;
+
+	VolumeMultiplier.bHasBeenSent = false;
+}
+
+int32 FCF_AudioParamBinder::AddFloat(const FName Name, const float Step)
+{
+	FParam& param = Params.AddDefaulted_GetRef();
+	param.Name = Name;
+	param.Step = Step;
+
+	return Params.Num() - 1;
+}
+
+int32 FCF_AudioParamBinder::AddInt(const FName Name)
+{
+	FParam& param = Params.AddDefaulted_GetRef();
+	param.Name = Name;
+	param.Step = 1.f;
+	param.bIsInt = true;
+
+	return Params.Num() - 1;
+}
+
+void FCF_AudioParamBinder::SetFloat(const int32 Handle, const float Value)
+{
+	if (Params.IsValidIndex(Handle))
+		SetValue(Params[Handle], Value);
+}
+
+void FCF_AudioParamBinder::SetInt(const int32 Handle, const int32 Value)
+{
+	if (Params.IsValidIndex(Handle))
+		SetValue(Params[Handle], static_cast<float>(Value));
+}
+
+void FCF_AudioParamBinder::SetVolumeMultiplier(const float Value)
+{
+	if (VolumeMultiplier.Step <= 0.f)
+		VolumeMultiplier.Step = .01f;
+
+	MarkDirty(VolumeMultiplier, Value);
+}
+
+void FCF_AudioParamBinder::Flush()
+{
+	VHS_SCOPE(AudioParamFlush);
+
+	UAudioComponent* audio = Audio.Get();
+	if (!audio)
+		return;
+
+	if (VolumeMultiplier.bIsDirty)
+	{
+		audio->SetVolumeMultiplier(VolumeMultiplier.Value);
+		VolumeMultiplier.SentValue = VolumeMultiplier.Value;
+		VolumeMultiplier.bHasBeenSent = true;
+		VolumeMultiplier.bIsDirty = false;
+
+		++IssuedCommands;
+		INC_DWORD_STAT(STAT_VHS_AudioCommandsIssued);
+	}
+
+	if (NumDirty == 0)
+		return;
+
+	TArray<FAudioParameter> batch;
+	batch.Reserve(NumDirty);
+
+	for (FParam& param : Params)
+	{
+		if (!param.bIsDirty)
+			continue;
+
+		if (param.bIsInt)
+			batch.Emplace(param.Name, FMath::RoundToInt32(param.Value));
+		else
+			batch.Emplace(param.Name, param.Value);
+
+		param.SentValue = param.Value;
+		param.bHasBeenSent = true;
+		param.bIsDirty = false;
+	}
+
+	NumDirty = 0;
+	audio->SetParameters(MoveTemp(batch));
+
+	++IssuedCommands;
+	INC_DWORD_STAT(STAT_VHS_AudioCommandsIssued);
+}
+
+void FCF_AudioParamBinder::SetValue(FParam& Param, const float Value)
+{
+	const bool bWasDirty = Param.bIsDirty;
+	if (MarkDirty(Param, Value) && !bWasDirty)
+		++NumDirty;
+	else if (bWasDirty && !Param.bIsDirty)
+		--NumDirty;
+}
+
+bool FCF_AudioParamBinder::MarkDirty(FParam& Param, const float Value)
+{
+	Param.Value = Param.Step > 0.f ? FMath::GridSnap(Value, Param.Step) : Value;
+
+	// Setting a value back to what the audio thread already has cancels a pending change
+	Param.bIsDirty = !Param.bHasBeenSent || Param.Value != Param.SentValue;
+
+	if (!Param.bIsDirty)
+	{
+		++SkippedCommands;
+		INC_DWORD_STAT(STAT_VHS_AudioCommandsSkipped);
+	}
+
+	return Param.bIsDirty;
+}
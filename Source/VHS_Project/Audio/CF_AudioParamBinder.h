@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// # Engine Forwards
+class UAudioComponent;
+
+/**
+ * Front end for the parameters of a single audio component. Values are quantised and compared against the last
+ * value sent, only the ones that actually changed reach the audio thread and they do so in one batch per Flush.
+ * Parameters are registered once and addressed by handle afterwards, no FName lookups on the hot path.
+ */
+class VHS_PROJECT_API FCF_AudioParamBinder
+{
+public:
+
+	void Setup(UAudioComponent* inAudio);
+
+	/** Step is the quantisation grid, changes smaller than it are never sent */
+	int32 AddFloat(const FName Name, const float Step = .01f);
+
+	int32 AddInt(const FName Name);
+
+	void SetFloat(const int32 Handle, const float Value);
+
+	void SetInt(const int32 Handle, const int32 Value);
+
+	void SetVolumeMultiplier(const float Value);
+
+	/** Sends every dirty value, call once per frame */
+	void Flush();
+
+	uint32 GetIssuedCommands() const { return IssuedCommands; }
+
+	uint32 GetSkippedCommands() const { return SkippedCommands; }
+
+private:
+
+	struct FParam
+	{
+		FName Name;
+		float Step = 0.f;
+		float Value = 0.f;
+		float SentValue = 0.f;
+		bool bIsInt = false;
+		bool bHasBeenSent = false;
+		bool bIsDirty = false;
+	};
+
+	TWeakObjectPtr<UAudioComponent> Audio;
+
+	TArray<FParam> Params;
+	int32 NumDirty = 0;
+
+	FParam VolumeMultiplier;
+
+	uint32 IssuedCommands = 0;
+	uint32 SkippedCommands = 0;
+
+	// -------------------------------------------------------------------------
+
+	void SetValue(FParam& Param, const float Value);
+
+	bool MarkDirty(FParam& Param, const float Value);
+};
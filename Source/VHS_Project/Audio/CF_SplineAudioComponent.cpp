@@ -0,0 +1,201 @@
+#include "CF_SplineAudioComponent.h"
+
+// # Engine Includes
+#include "Components/SplineComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+
+// # Project Includes
+#include "VHS_Project.h"
+
+DECLARE_CYCLE_STAT(TEXT("Spline Audio Tick"), STAT_VHS_SplineAudioTick, STATGROUP_VHS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Spline Audio Full Scans"), STAT_VHS_SplineAudioFullScans, STATGROUP_VHS);
+
+UCF_SplineAudioComponent::UCF_SplineAudioComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickInterval = UpdateInterval;
+}
+
+void UCF_SplineAudioComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// The constructor only sees the C++ default, Blueprints may have edited it
+	SetComponentTickInterval(bIsInRange ? UpdateInterval : PausedUpdateInterval);
+
+	if (!Spline && GetOwner())
+		Setup(GetOwner()->FindComponentByClass<USplineComponent>());
+}
+
+void UCF_SplineAudioComponent::Setup(USplineComponent* inSpline)
+{
+	Spline = inSpline;
+
+	Samples.Reset();
+	Bounds = FBox(ForceInit);
+	ClosestIdx = INDEX_NONE;
+
+	if (!Spline)
+		return;
+
+	bIsClosedLoop = Spline->IsClosedLoop();
+
+	const float length = Spline->GetSplineLength();
+	const int32 num = FMath::Max(FMath::CeilToInt32(length / FMath::Max(SampleSpacing, 1.f)) + 1, 2);
+
+	Samples.Reserve(num);
+	for (int32 i = 0; i < num; ++i)
+	{
+		const FVector& sample = Samples.Add_GetRef(Spline->GetLocationAtDistanceAlongSpline(length * i / (num - 1), ESplineCoordinateSpace::World));
+		Bounds += sample;
+	}
+
+	// The last sample of a loop is the first one again
+	if (bIsClosedLoop)
+		Samples.Pop(false);
+}
+
+void UCF_SplineAudioComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	VHS_SCOPE(SplineAudioTick);
+
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	const APlayerController* pc = GetWorld()->GetFirstPlayerController();
+	if (!pc || Samples.Num() < 2)
+		return;
+
+	FVector listener;
+	FVector frontDir;
+	FVector rightDir;
+	pc->GetAudioListenerPosition(listener, frontDir, rightDir);
+
+	// Against the bounds first, most of the episode is out of range of any given emitter
+	const float rangeSq = FMath::Square(GetAudibleRange());
+	if (rangeSq > 0.f && Bounds.ComputeSquaredDistanceToPoint(listener) > rangeSq)
+	{
+		SetInRange(false);
+		return;
+	}
+
+	const float movedSq = FVector::DistSquared(listener, LastListenerLocation);
+	if (bIsInRange && ClosestIdx != INDEX_NONE && movedSq < FMath::Square(MoveThreshold))
+		return;
+
+	const bool bFullSearch = !bIsInRange || movedSq > FMath::Square(JumpDistance);
+	LastListenerLocation = listener;
+
+	ClosestIdx = FindClosestSample(listener, bFullSearch);
+	const FVector closest = RefineClosestPoint(ClosestIdx, listener);
+
+	if (rangeSq > 0.f && FVector::DistSquared(closest, listener) > rangeSq)
+	{
+		SetInRange(false);
+		return;
+	}
+
+	SetInRange(true);
+	SetWorldLocation(closest);
+}
+
+float UCF_SplineAudioComponent::GetAudibleRange() const
+{
+	if (AudibleRange > 0.f)
+		return AudibleRange;
+
+	const FSoundAttenuationSettings* attenuation = GetAttenuationSettingsToApply();
+	return attenuation ? attenuation->GetMaxDimension() : 0.f;
+}
+
+int32 UCF_SplineAudioComponent::GetNeighbor(const int32 Idx, const int32 Direction) const
+{
+	const int32 neighbor = Idx + Direction;
+	if (Samples.IsValidIndex(neighbor))
+		return neighbor;
+
+	return bIsClosedLoop ? (neighbor + Samples.Num()) % Samples.Num() : INDEX_NONE;
+}
+
+int32 UCF_SplineAudioComponent::FindClosestSample(const FVector& Location, const bool bFullSearch) const
+{
+	if (bFullSearch || !Samples.IsValidIndex(ClosestIdx))
+	{
+		INC_DWORD_STAT(STAT_VHS_SplineAudioFullScans);
+
+		int32 closest = 0;
+		float closestDistSq = MAX_flt;
+		for (int32 i = 0; i < Samples.Num(); ++i)
+		{
+			const float distSq = FVector::DistSquared(Samples[i], Location);
+			if (distSq < closestDistSq)
+			{
+				closestDistSq = distSq;
+				closest = i;
+			}
+		}
+
+		return closest;
+	}
+
+	// The listener moved a little since the last update, the closest sample is at most a few steps away
+	int32 idx = ClosestIdx;
+	float distSq = FVector::DistSquared(Samples[idx], Location);
+
+	for (;;)
+	{
+		const int32 prev = GetNeighbor(idx, -1);
+		const int32 next = GetNeighbor(idx, 1);
+		const float prevDistSq = prev != INDEX_NONE ? FVector::DistSquared(Samples[prev], Location) : MAX_flt;
+		const float nextDistSq = next != INDEX_NONE ? FVector::DistSquared(Samples[next], Location) : MAX_flt;
+
+		if (prevDistSq < distSq && prevDistSq <= nextDistSq)
+		{
+			idx = prev;
+			distSq = prevDistSq;
+		}
+		else if (nextDistSq < distSq)
+		{
+			idx = next;
+			distSq = nextDistSq;
+		}
+		else
+			break;
+	}
+
+	return idx;
+}
+
+FVector UCF_SplineAudioComponent::RefineClosestPoint(const int32 Idx, const FVector& Location) const
+{
+	FVector closest = Samples[Idx];
+	float closestDistSq = FVector::DistSquared(closest, Location);
+
+	for (const int32 direction : { -1, 1 })
+	{
+		const int32 neighbor = GetNeighbor(Idx, direction);
+		if (neighbor == INDEX_NONE)
+			continue;
+
+		const FVector point = FMath::ClosestPointOnSegment(Location, Samples[Idx], Samples[neighbor]);
+		const float distSq = FVector::DistSquared(point, Location);
+		if (distSq < closestDistSq)
+		{
+			closestDistSq = distSq;
+			closest = point;
+		}
+	}
+
+	return closest;
+}
+
+void UCF_SplineAudioComponent::SetInRange(const bool bInRange)
+{
+	if (bIsInRange == bInRange)
+		return;
+
+	bIsInRange = bInRange;
+
+	SetPaused(!bInRange);
+	SetComponentTickInterval(bInRange ? UpdateInterval : PausedUpdateInterval);
+}
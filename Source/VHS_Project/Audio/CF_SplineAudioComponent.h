@@ -0,0 +1,81 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/AudioComponent.h"
+
+#include "CF_SplineAudioComponent.generated.h"
+
+// # Engine Forwards
+class USplineComponent;
+
+/**
+ * Ambient emitter that follows the point of a spline closest to the listener, replaces BP_SoundSpline. The spline
+ * is sampled once at even arc length steps and the closest sample is tracked by walking from last update's one, so
+ * an update is a couple of distance checks. The emitter only moves once the listener has, and pauses while the
+ * listener is out of audible range of the whole spline.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class VHS_PROJECT_API UCF_SplineAudioComponent : public UAudioComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UCF_SplineAudioComponent();
+
+	/** Samples inSpline in world space, call again if it moves or changes shape */
+	UFUNCTION(BlueprintCallable, Category = "Audio")
+	void Setup(USplineComponent* inSpline);
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+
+	virtual void BeginPlay() override;
+
+	/** Arc length in cm between two samples */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | SplineAudio")
+	float SampleSpacing = 50.f;
+
+	/** Listener movement in cm before the emitter is moved again */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | SplineAudio")
+	float MoveThreshold = 25.f;
+
+	/** 0 uses the extent of the attenuation settings */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | SplineAudio")
+	float AudibleRange = 0.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | SplineAudio")
+	float UpdateInterval = .1f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | SplineAudio")
+	float PausedUpdateInterval = .5f;
+
+	/** A listener moving further than this between two updates, e.g. a teleport, searches the whole spline */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | SplineAudio")
+	float JumpDistance = 1000.f;
+
+	UPROPERTY() USplineComponent* Spline = nullptr;
+
+	TArray<FVector> Samples;
+	FBox Bounds = FBox(ForceInit);
+	bool bIsClosedLoop = false;
+
+	int32 ClosestIdx = INDEX_NONE;
+	FVector LastListenerLocation = FVector::ZeroVector;
+	bool bIsInRange = true;
+
+	// -------------------------------------------------------------------------
+
+	float GetAudibleRange() const;
+
+	int32 GetNeighbor(const int32 Idx, const int32 Direction) const;
+
+	/** Walks downhill from ClosestIdx, or scans every sample when there's nothing to start from */
+	int32 FindClosestSample(const FVector& Location, const bool bFullSearch) const;
+
+	/** Closest point on the two segments around the sample */
+	FVector RefineClosestPoint(const int32 Idx, const FVector& Location) const;
+
+	void SetInRange(const bool bInRange);
+};
@@ -0,0 +1,367 @@
+#include "CF_BenchmarkSubsystem.h"
+
+// # Engine Includes
+#include "Dom/JsonObject.h"
+#include "Engine/GameInstance.h"
+#include "Engine/LevelStreaming.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/World.h"
+#include "EnhancedInputSubsystems.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/PlatformMemory.h"
+#include "InputAction.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+// # Project Includes
+#include "VHS_Project.h"
+#include "CF_Player.h"
+#include "Dialogue/CF_DialogueBankSubsystem.h"
+
+namespace BenchmarkMetrics
+{
+	struct FMetric
+	{
+		const TCHAR* Path;
+
+		/** Regressions smaller than this are noise whatever the tolerance */
+		double MinDelta;
+	};
+
+	// Higher is worse for all of them
+	const FMetric Metrics[] =
+	{
+		{ TEXT("gameThreadMs.p50"), .1 },
+		{ TEXT("gameThreadMs.p90"), .2 },
+		{ TEXT("gameThreadMs.p99"), .5 },
+		{ TEXT("hitches"), 2.0 },
+		{ TEXT("peakMemoryMB"), 16.0 },
+		{ TEXT("loadTimes.map"), .5 },
+		{ TEXT("loadTimes.sublevels"), .5 },
+		{ TEXT("loadTimes.dialogues"), .5 },
+	};
+
+	float Percentile(const TArray<float>& Sorted, const float Percent)
+	{
+		if (Sorted.IsEmpty())
+			return 0.f;
+
+		const int32 idx = FMath::Clamp(FMath::CeilToInt32(Percent * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+		return Sorted[idx];
+	}
+
+	bool TryGetMetric(const FJsonObject& Object, const FString& Path, double& OutValue)
+	{
+		FString group;
+		FString field;
+		if (!Path.Split(TEXT("."), &group, &field))
+			return Object.TryGetNumberField(Path, OutValue);
+
+		const TSharedPtr<FJsonObject>* groupObject = nullptr;
+		return Object.TryGetObjectField(group, groupObject) && (*groupObject)->TryGetNumberField(field, OutValue);
+	}
+}
+
+// Action, value, duration, press, move
+const UCF_BenchmarkSubsystem::FRouteStep UCF_BenchmarkSubsystem::Route[] =
+{
+	{ EPlayerAction::MAX,			{ 0.f, 0.f },	5.f,	false,	true },		// Walk
+	{ EPlayerAction::Look,			{ 1.f, 0.f },	3.f,	false,	true },		// Walk and turn
+	{ EPlayerAction::Sprint,		{ 1.f, 0.f },	5.f,	false,	true },		// Sprint
+	{ EPlayerAction::Crouch,		{ 1.f, 0.f },	.1f,	true,	false },	// Crouch
+	{ EPlayerAction::MAX,			{ 0.f, 0.f },	4.f,	false,	true },		// Crouched walk
+	{ EPlayerAction::Crouch,		{ 1.f, 0.f },	2.f,	true,	false },	// Stand up
+	{ EPlayerAction::LeanLeft,		{ 1.f, 0.f },	1.5f,	false,	false },	// Lean left
+	{ EPlayerAction::LeanRight,		{ 1.f, 0.f },	1.5f,	false,	false },	// Lean right
+	{ EPlayerAction::Zoom,			{ 1.f, 0.f },	2.f,	false,	false },	// Zoom in and out
+	{ EPlayerAction::Flashlight,	{ 1.f, 0.f },	.1f,	true,	false },	// Flashlight on
+	{ EPlayerAction::Look,			{ -1.f, .2f },	3.f,	false,	true },		// Walk with the flashlight
+	{ EPlayerAction::Flashlight,	{ 1.f, 0.f },	.1f,	true,	false },	// Flashlight off
+	{ EPlayerAction::Jump,			{ 1.f, 0.f },	1.f,	true,	true },		// Jump
+	{ EPlayerAction::MAX,			{ 0.f, 0.f },	2.f,	false,	false },	// Idle
+};
+
+const int32 UCF_BenchmarkSubsystem::RouteNum = UE_ARRAY_COUNT(UCF_BenchmarkSubsystem::Route);
+
+bool UCF_BenchmarkSubsystem::IsBenchmarkRun()
+{
+	return FParse::Param(FCommandLine::Get(), TEXT("VHSBenchmark"));
+}
+
+bool UCF_BenchmarkSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return IsBenchmarkRun() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UCF_BenchmarkSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	DH_BeginFrame = FCoreDelegates::OnBeginFrame.AddUObject(this, &UCF_BenchmarkSubsystem::HandleBeginFrame);
+	DH_EndFrame = FCoreDelegates::OnEndFrame.AddUObject(this, &UCF_BenchmarkSubsystem::HandleEndFrame);
+}
+
+void UCF_BenchmarkSubsystem::Deinitialize()
+{
+	FCoreDelegates::OnBeginFrame.Remove(DH_BeginFrame);
+	FCoreDelegates::OnEndFrame.Remove(DH_EndFrame);
+
+	if (auto* bank = UGameInstance::GetSubsystem<UCF_DialogueBankSubsystem>(GetWorld()->GetGameInstance()))
+		bank->OnDialoguesReady.Remove(DH_DialoguesReady);
+
+	Super::Deinitialize();
+}
+
+void UCF_BenchmarkSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	BeginPlayTime = FPlatformTime::Seconds();
+	MapLoadTime = static_cast<float>(BeginPlayTime - GStartTime);
+
+	if (auto* bank = UGameInstance::GetSubsystem<UCF_DialogueBankSubsystem>(InWorld.GetGameInstance()))
+		DH_DialoguesReady = bank->OnDialoguesReady.AddUObject(this, &UCF_BenchmarkSubsystem::HandleDialoguesReady);
+
+	UE_LOG(LogVHS, Display, TEXT("Benchmark: %s loaded in %.2fs"), *InWorld.GetMapName(), MapLoadTime);
+}
+
+void UCF_BenchmarkSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const float deltaTime = static_cast<float>(FApp::GetDeltaTime());
+	PhaseTime += deltaTime;
+
+	switch (Phase)
+	{
+	case EBenchmarkPhase::Setup:
+		Player = Cast<ACF_Player>(UGameplayStatics::GetPlayerPawn(this, 0));
+		if (Player.IsValid() && AreSublevelsLoaded())
+		{
+			SublevelsLoadTime = static_cast<float>(FPlatformTime::Seconds() - BeginPlayTime);
+			Phase = EBenchmarkPhase::Warmup;
+			PhaseTime = 0.f;
+		}
+		else if (PhaseTime > SetupTimeout)
+		{
+			UE_LOG(LogVHS, Error, TEXT("Benchmark: no ACF_Player or sublevels still streaming after %.0fs"), SetupTimeout);
+			Finish(2);
+		}
+		break;
+
+	case EBenchmarkPhase::Warmup:
+		if (PhaseTime >= WarmupTime)
+		{
+			Phase = EBenchmarkPhase::Route;
+			PhaseTime = 0.f;
+			StepIdx = 0;
+			StepTime = 0.f;
+			FrameTimes.Reset();
+			Hitches = 0;
+		}
+		break;
+
+	case EBenchmarkPhase::Route:
+		TickRoute(deltaTime);
+		break;
+
+	default:
+		break;
+	}
+}
+
+TStatId UCF_BenchmarkSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCF_BenchmarkSubsystem, STATGROUP_Tickables);
+}
+
+bool UCF_BenchmarkSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCF_BenchmarkSubsystem::HandleBeginFrame()
+{
+	FrameStartTime = FPlatformTime::Seconds();
+}
+
+void UCF_BenchmarkSubsystem::HandleEndFrame()
+{
+	if (Phase != EBenchmarkPhase::Route || FrameStartTime <= 0.0)
+		return;
+
+	// Begin to end of frame on the game thread, independent of the RHI so it holds under -nullrhi
+	const float frameMs = static_cast<float>((FPlatformTime::Seconds() - FrameStartTime) * 1000.0);
+	FrameTimes.Add(frameMs);
+
+	if (frameMs > HitchThresholdMs)
+		++Hitches;
+}
+
+void UCF_BenchmarkSubsystem::HandleDialoguesReady()
+{
+	if (DialoguesReadyTime < 0.f)
+		DialoguesReadyTime = static_cast<float>(FPlatformTime::Seconds() - BeginPlayTime);
+}
+
+bool UCF_BenchmarkSubsystem::AreSublevelsLoaded() const
+{
+	for (const ULevelStreaming* level : GetWorld()->GetStreamingLevels())
+	{
+		if (level && level->ShouldBeLoaded() && !level->IsLevelLoaded())
+			return false;
+	}
+
+	return true;
+}
+
+void UCF_BenchmarkSubsystem::TickRoute(const float DeltaTime)
+{
+	if (!Player.IsValid())
+	{
+		UE_LOG(LogVHS, Error, TEXT("Benchmark: player destroyed during the route"));
+		Finish(2);
+		return;
+	}
+
+	const FRouteStep& step = Route[StepIdx];
+	const bool bHasAction = step.Action != EPlayerAction::MAX;
+
+	// Held input has to be injected every frame, a press only on the first one
+	if (bHasAction && (!step.bPress || StepTime == 0.f))
+		InjectAction(step.Action, step.Value);
+
+	if (step.bMove)
+		InjectAction(EPlayerAction::Move, FVector2D(0.f, 1.f));
+
+	StepTime += DeltaTime;
+	if (StepTime < step.Duration)
+		return;
+
+	if (bHasAction && !step.bPress)
+		InjectAction(step.Action, FVector2D::ZeroVector);
+
+	StepTime = 0.f;
+	if (++StepIdx >= RouteNum)
+		Finish();
+}
+
+void UCF_BenchmarkSubsystem::InjectAction(const EPlayerAction Action, const FVector2D& Value) const
+{
+	const ACF_Player* player = Player.Get();
+	const UInputAction* action = player ? player->GetInputAction(Action) : nullptr;
+	const APlayerController* pc = player ? player->GetController<APlayerController>() : nullptr;
+	if (!action || !pc || !pc->GetLocalPlayer())
+		return;
+
+	if (auto* input = pc->GetLocalPlayer()->GetSubsystem<UEnhancedInputLocalPlayerSubsystem>())
+		input->InjectInputForAction(action, FInputActionValue(action->ValueType, FVector(Value.X, Value.Y, 0.f)));
+}
+
+void UCF_BenchmarkSubsystem::Finish(const int32 FailureCode)
+{
+	Phase = EBenchmarkPhase::Done;
+
+	TSharedRef<FJsonObject> report = BuildReport();
+
+	TArray<FString> regressions;
+	FString baselinePath;
+	if (FailureCode == 0 && FParse::Value(FCommandLine::Get(), TEXT("VHSBenchmarkBaseline="), baselinePath))
+	{
+		FString baselineText;
+		TSharedPtr<FJsonObject> baseline;
+
+		if (FFileHelper::LoadFileToString(baselineText, *baselinePath) && FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(baselineText), baseline) && baseline.IsValid())
+		{
+			double tolerance = .1;
+			FParse::Value(FCommandLine::Get(), TEXT("VHSBenchmarkTolerance="), tolerance);
+
+			CompareWithBaseline(*report, *baseline, tolerance, regressions);
+		}
+		else
+			UE_LOG(LogVHS, Warning, TEXT("Benchmark: couldn't read baseline %s"), *baselinePath);
+	}
+
+	TArray<TSharedPtr<FJsonValue>> regressionValues;
+	for (const FString& regression : regressions)
+	{
+		UE_LOG(LogVHS, Error, TEXT("Benchmark regression: %s"), *regression);
+		regressionValues.Add(MakeShared<FJsonValueString>(regression));
+	}
+
+	report->SetArrayField(TEXT("regressions"), regressionValues);
+	report->SetBoolField(TEXT("completed"), FailureCode == 0);
+
+	FString outPath;
+	if (!FParse::Value(FCommandLine::Get(), TEXT("VHSBenchmarkOut="), outPath))
+		outPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / FString::Printf(TEXT("%s_%s.json"), *GetWorld()->GetMapName(), *FDateTime::Now().ToString());
+
+	FString reportText;
+	FJsonSerializer::Serialize(report, TJsonWriterFactory<>::Create(&reportText));
+
+	if (FFileHelper::SaveStringToFile(reportText, *outPath))
+		UE_LOG(LogVHS, Display, TEXT("Benchmark: report written to %s"), *outPath);
+	else
+		UE_LOG(LogVHS, Error, TEXT("Benchmark: couldn't write %s"), *outPath);
+
+	const int32 exitCode = FailureCode != 0 ? FailureCode : regressions.IsEmpty() ? 0 : 1;
+	FPlatformMisc::RequestExitWithStatus(false, static_cast<uint8>(exitCode));
+}
+
+TSharedRef<FJsonObject> UCF_BenchmarkSubsystem::BuildReport() const
+{
+	TArray<float> sorted = FrameTimes;
+	sorted.Sort();
+
+	double total = 0.0;
+	for (const float frameMs : sorted)
+		total += frameMs;
+
+	auto gameThread = MakeShared<FJsonObject>();
+	gameThread->SetNumberField(TEXT("mean"), sorted.IsEmpty() ? 0.0 : total / sorted.Num());
+	gameThread->SetNumberField(TEXT("p50"), BenchmarkMetrics::Percentile(sorted, .5f));
+	gameThread->SetNumberField(TEXT("p90"), BenchmarkMetrics::Percentile(sorted, .9f));
+	gameThread->SetNumberField(TEXT("p95"), BenchmarkMetrics::Percentile(sorted, .95f));
+	gameThread->SetNumberField(TEXT("p99"), BenchmarkMetrics::Percentile(sorted, .99f));
+	gameThread->SetNumberField(TEXT("max"), sorted.IsEmpty() ? 0.0 : sorted.Last());
+
+	auto loadTimes = MakeShared<FJsonObject>();
+	loadTimes->SetNumberField(TEXT("map"), MapLoadTime);
+	loadTimes->SetNumberField(TEXT("sublevels"), SublevelsLoadTime);
+	loadTimes->SetNumberField(TEXT("dialogues"), DialoguesReadyTime);
+
+	auto report = MakeShared<FJsonObject>();
+	report->SetStringField(TEXT("map"), GetWorld()->GetMapName());
+	report->SetNumberField(TEXT("frames"), sorted.Num());
+	report->SetObjectField(TEXT("gameThreadMs"), gameThread);
+	report->SetNumberField(TEXT("hitches"), Hitches);
+	report->SetNumberField(TEXT("hitchThresholdMs"), HitchThresholdMs);
+	report->SetNumberField(TEXT("peakMemoryMB"), FPlatformMemory::GetStats().PeakUsedPhysical / (1024.0 * 1024.0));
+	report->SetObjectField(TEXT("loadTimes"), loadTimes);
+
+	return report;
+}
+
+void UCF_BenchmarkSubsystem::CompareWithBaseline(const FJsonObject& Report, const FJsonObject& Baseline, const double Tolerance, TArray<FString>& OutRegressions)
+{
+	for (const auto& metric : BenchmarkMetrics::Metrics)
+	{
+		double current = 0.0;
+		double baseline = 0.0;
+
+		// Metrics missing on either side, or never reached (negative load times), aren't compared
+		if (!BenchmarkMetrics::TryGetMetric(Report, metric.Path, current) || !BenchmarkMetrics::TryGetMetric(Baseline, metric.Path, baseline) || baseline < 0.0 || current < 0.0)
+			continue;
+
+		if (current > baseline * (1.0 + Tolerance) && current - baseline > metric.MinDelta)
+			OutRegressions.Add(FString::Printf(TEXT("%s %.3f -> %.3f (+%.1f%%)"), metric.Path, baseline, current, baseline > 0.0 ? (current / baseline - 1.0) * 100.0 : 100.0));
+	}
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "CF_BenchmarkSubsystem.generated.h"
+
+// # Engine Forwards
+class FJsonObject;
+
+// # Project Forwards
+class ACF_Player;
+enum class EPlayerAction : uint8;
+
+/**
+ * Headless Episode_01 benchmark, only created with -VHSBenchmark:
+ *
+ *   VHS_Project -game -nullrhi -unattended -VHSBenchmark [-VHSBenchmarkOut=<json>] [-VHSBenchmarkBaseline=<json>] [-VHSBenchmarkTolerance=0.1]
+ *
+ * Waits for the sublevels and the player, drives a fixed route through Enhanced Input and writes game thread
+ * percentiles, hitches, peak memory and load times as json. The process exits with 1 if any metric regressed
+ * past the baseline by more than the tolerance, 2 if the run couldn't complete and 0 otherwise.
+ */
+UCLASS()
+class VHS_PROJECT_API UCF_BenchmarkSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	static bool IsBenchmarkRun();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Seconds after everything is resident before the route starts, lets shaders and streaming settle */
+	float WarmupTime = 3.f;
+
+	/** Seconds to wait for the sublevels and the player before the run is abandoned */
+	float SetupTimeout = 60.f;
+
+	float HitchThresholdMs = 50.f;
+
+	struct FRouteStep
+	{
+		EPlayerAction Action;
+		FVector2D Value;
+		float Duration;
+
+		/** Fired once at the start of the step instead of held */
+		bool bPress;
+
+		/** Move forward during the step */
+		bool bMove;
+	};
+
+	static const FRouteStep Route[];
+	static const int32 RouteNum;
+
+	enum class EBenchmarkPhase : uint8
+	{
+		Setup,
+		Warmup,
+		Route,
+		Done
+	};
+
+	EBenchmarkPhase Phase = EBenchmarkPhase::Setup;
+	float PhaseTime = 0.f;
+
+	TWeakObjectPtr<ACF_Player> Player;
+
+	int32 StepIdx = INDEX_NONE;
+	float StepTime = 0.f;
+
+	// Metrics --->
+	double BeginPlayTime = 0.0;
+	float MapLoadTime = -1.f;
+	float SublevelsLoadTime = -1.f;
+	float DialoguesReadyTime = -1.f;
+
+	TArray<float> FrameTimes;
+	double FrameStartTime = 0.0;
+	int32 Hitches = 0;
+
+	FDelegateHandle DH_BeginFrame;
+	FDelegateHandle DH_EndFrame;
+	FDelegateHandle DH_DialoguesReady;
+
+	// -------------------------------------------------------------------------
+
+	void HandleBeginFrame();
+
+	void HandleEndFrame();
+
+	void HandleDialoguesReady();
+
+	bool AreSublevelsLoaded() const;
+
+	void TickRoute(const float DeltaTime);
+
+	void InjectAction(const EPlayerAction Action, const FVector2D& Value) const;
+
+	void Finish(const int32 FailureCode = 0);
+
+	TSharedRef<FJsonObject> BuildReport() const;
+
+	/** Appends a line per metric that's worse than the baseline by more than the tolerance */
+	static void CompareWithBaseline(const FJsonObject& Report, const FJsonObject& Baseline, const double Tolerance, TArray<FString>& OutRegressions);
+};
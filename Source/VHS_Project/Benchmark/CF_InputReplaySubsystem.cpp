@@ -0,0 +1,352 @@
+#include "CF_InputReplaySubsystem.h"
+
+// # Engine Includes
+#include "Engine/GameInstance.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/World.h"
+#include "EnhancedInputSubsystems.h"
+#include "EnhancedPlayerInput.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/FileManager.h"
+#include "InputAction.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+// # Project Includes
+#include "VHS_Project.h"
+#include "CF_Player.h"
+#include "Subsystems/CF_RandomSubsystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("Input Replay Tick"), STAT_VHS_InputReplayTick, STATGROUP_VHS);
+
+namespace InputReplay
+{
+	constexpr int32 NumActions = static_cast<int32>(EPlayerAction::MAX);
+
+	static_assert(NumActions <= 16, "The per-frame change mask is a uint16");
+}
+
+bool UCF_InputReplaySubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	const TCHAR* cmd = FCommandLine::Get();
+	return (FCString::Strifind(cmd, TEXT("-VHSRecord=")) || FCString::Strifind(cmd, TEXT("-VHSReplay="))) && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UCF_InputReplaySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const TCHAR* cmd = FCommandLine::Get();
+
+	if (FParse::Value(cmd, TEXT("VHSReplay="), FilePath))
+	{
+		if (!LoadRecording())
+		{
+			UE_LOG(LogVHS, Error, TEXT("Input replay: couldn't read %s"), *FilePath);
+			return;
+		}
+
+		Mode = EReplayMode::Replay;
+	}
+	else if (FParse::Value(cmd, TEXT("VHSRecord="), FilePath))
+	{
+		Mode = EReplayMode::Record;
+		Values.Init(FInputActionValue(), InputReplay::NumActions);
+	}
+	else
+		return;
+
+	// The random subsystem read the seed of the replay before any stream was made, a recording stores the session one
+	if (const auto* random = GetWorld()->GetGameInstance() ? GetWorld()->GetGameInstance()->GetSubsystem<UCF_RandomSubsystem>() : nullptr)
+	{
+		if (Mode == EReplayMode::Record)
+			Seed = random->GetSessionSeed();
+		else if (Seed != random->GetSessionSeed())
+			UE_LOG(LogVHS, Warning, TEXT("Input replay: session seed %d overrides the recorded %d"), random->GetSessionSeed(), Seed);
+	}
+
+	UE_LOG(LogVHS, Display, TEXT("Input replay: %s %s, seed %d"), Mode == EReplayMode::Record ? TEXT("recording") : TEXT("replaying"), *FilePath, Seed);
+}
+
+void UCF_InputReplaySubsystem::Deinitialize()
+{
+	if (Mode == EReplayMode::Record && bIsRunning)
+	{
+		if (SaveRecording())
+			UE_LOG(LogVHS, Display, TEXT("Input replay: %u frames (%d bytes) written to %s"), NumFrames, Frames.Num(), *FilePath);
+		else
+			UE_LOG(LogVHS, Error, TEXT("Input replay: couldn't write %s"), *FilePath);
+	}
+
+	if (Mode == EReplayMode::Replay && bIsRunning)
+		FApp::SetUseFixedTimeStep(false);
+
+	Super::Deinitialize();
+}
+
+void UCF_InputReplaySubsystem::Tick(float DeltaTime)
+{
+	VHS_SCOPE(InputReplayTick);
+
+	Super::Tick(DeltaTime);
+
+	if (Mode == EReplayMode::None)
+		return;
+
+	if (!bIsRunning)
+	{
+		Player = Cast<ACF_Player>(UGameplayStatics::GetPlayerPawn(this, 0));
+		if (Player.IsValid() && GetInputSubsystem())
+			Start();
+
+		return;
+	}
+
+	if (Mode == EReplayMode::Record)
+		RecordFrame(static_cast<float>(FApp::GetDeltaTime()));
+	else if (!ReplayFrame())
+		StopReplay();
+}
+
+TStatId UCF_InputReplaySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCF_InputReplaySubsystem, STATGROUP_Tickables);
+}
+
+bool UCF_InputReplaySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+UEnhancedInputLocalPlayerSubsystem* UCF_InputReplaySubsystem::GetInputSubsystem() const
+{
+	const APlayerController* pc = Player.IsValid() ? Player->GetController<APlayerController>() : nullptr;
+	const ULocalPlayer* localPlayer = pc ? pc->GetLocalPlayer() : nullptr;
+
+	return localPlayer ? localPlayer->GetSubsystem<UEnhancedInputLocalPlayerSubsystem>() : nullptr;
+}
+
+void UCF_InputReplaySubsystem::Start()
+{
+	bIsRunning = true;
+
+	if (Mode == EReplayMode::Record)
+	{
+		// Actions missing on the player are recorded as axis 1D and never change
+		ValueTypes.SetNum(InputReplay::NumActions);
+		for (int32 i = 0; i < InputReplay::NumActions; ++i)
+		{
+			const UInputAction* action = Player->GetInputAction(static_cast<EPlayerAction>(i));
+			ValueTypes[i] = action ? action->ValueType : EInputActionValueType::Axis1D;
+		}
+
+		// Recording starts with the next frame, the one the first replayed frame is injected into
+		return;
+	}
+
+	// Hardware input would desync the replay, injection goes through the actions and doesn't need the mappings
+	GetInputSubsystem()->RemoveMappingContext(Player->GetInputMappingContext());
+
+	FApp::SetUseFixedTimeStep(true);
+
+	if (!ReplayFrame())
+		StopReplay();
+}
+
+void UCF_InputReplaySubsystem::RecordFrame(const float DeltaTime)
+{
+	const UEnhancedInputLocalPlayerSubsystem* input = Player.IsValid() ? GetInputSubsystem() : nullptr;
+	const UEnhancedPlayerInput* playerInput = input ? input->GetPlayerInput() : nullptr;
+	if (!playerInput)
+		return;
+
+	FInputActionValue current[InputReplay::NumActions];
+	uint16 changedMask = 0;
+
+	for (int32 i = 0; i < InputReplay::NumActions; ++i)
+	{
+		if (const UInputAction* action = Player->GetInputAction(static_cast<EPlayerAction>(i)))
+			current[i] = FInputActionValue(ValueTypes[i], playerInput->GetActionValue(action).Get<FVector>());
+
+		if (current[i].Get<FVector>() != Values[i].Get<FVector>())
+			changedMask |= 1 << i;
+	}
+
+	// Frame: delta time, mask of the actions that changed, then their new values. Booleans only flip their bit
+	FMemoryWriter writer(Frames, false, true);
+
+	float deltaTime = DeltaTime;
+	writer << deltaTime;
+	writer << changedMask;
+
+	for (int32 i = 0; i < InputReplay::NumActions; ++i)
+	{
+		if (!(changedMask & (1 << i)))
+			continue;
+
+		Values[i] = current[i];
+		SerializeValue(writer, ValueTypes[i], Values[i]);
+	}
+
+	++NumFrames;
+}
+
+bool UCF_InputReplaySubsystem::ReplayFrame()
+{
+	UEnhancedInputLocalPlayerSubsystem* input = Player.IsValid() ? GetInputSubsystem() : nullptr;
+	if (!input || FrameIdx >= NumFrames)
+		return false;
+
+	FMemoryReader reader(Frames);
+	reader.Seek(ReadOffset);
+
+	float deltaTime = 0.f;
+	uint16 changedMask = 0;
+	reader << deltaTime;
+	reader << changedMask;
+
+	for (int32 i = 0; i < InputReplay::NumActions; ++i)
+	{
+		if (!(changedMask & (1 << i)))
+			continue;
+
+		if (ValueTypes[i] == EInputActionValueType::Boolean)
+			Values[i] = FInputActionValue(!Values[i].Get<bool>());
+		else
+			SerializeValue(reader, ValueTypes[i], Values[i]);
+	}
+
+	if (reader.IsError())
+		return false;
+
+	ReadOffset = reader.Tell();
+	++FrameIdx;
+
+	// Applies to the next frame, the same one the injected input is processed in
+	FApp::SetFixedDeltaTime(deltaTime);
+
+	// Held values have to be injected every frame, released ones are left out so the triggers complete
+	for (int32 i = 0; i < InputReplay::NumActions; ++i)
+	{
+		const UInputAction* action = Player->GetInputAction(static_cast<EPlayerAction>(i));
+		if (action && Values[i].IsNonZero())
+			input->InjectInputForAction(action, Values[i]);
+	}
+
+	return true;
+}
+
+void UCF_InputReplaySubsystem::StopReplay()
+{
+	if (Mode != EReplayMode::Replay)
+		return;
+
+	Mode = EReplayMode::None;
+	FApp::SetUseFixedTimeStep(false);
+
+	if (auto* input = Player.IsValid() ? GetInputSubsystem() : nullptr)
+		input->AddMappingContext(Player->GetInputMappingContext(), 0);
+
+	UE_LOG(LogVHS, Display, TEXT("Input replay: finished after %u of %u frames"), FrameIdx, NumFrames);
+
+	if (FApp::IsUnattended())
+		FPlatformMisc::RequestExit(false);
+}
+
+bool UCF_InputReplaySubsystem::SaveRecording() const
+{
+	TArray<uint8> bytes;
+	bytes.Reserve(Frames.Num() + 64);
+
+	FMemoryWriter writer(bytes);
+
+	uint32 magic = FileMagic;
+	uint16 version = FileVersion;
+	int32 seed = Seed;
+	uint32 numFrames = NumFrames;
+	uint8 numActions = static_cast<uint8>(InputReplay::NumActions);
+
+	writer << magic << version << seed << numFrames << numActions;
+	for (EInputActionValueType valueType : ValueTypes)
+		writer << valueType;
+
+	bytes.Append(Frames);
+
+	return FFileHelper::SaveArrayToFile(bytes, *FilePath);
+}
+
+bool UCF_InputReplaySubsystem::ReadSeed(const FString& Path, int32& OutSeed)
+{
+	TUniquePtr<FArchive> reader(IFileManager::Get().CreateFileReader(*Path));
+	if (!reader)
+		return false;
+
+	uint32 magic = 0;
+	uint16 version = 0;
+	int32 seed = 0;
+
+	*reader << magic << version << seed;
+	if (reader->IsError() || magic != FileMagic || version != FileVersion)
+		return false;
+
+	OutSeed = seed;
+	return true;
+}
+
+bool UCF_InputReplaySubsystem::LoadRecording()
+{
+	TArray<uint8> bytes;
+	if (!FFileHelper::LoadFileToArray(bytes, *FilePath))
+		return false;
+
+	FMemoryReader reader(bytes);
+
+	uint32 magic = 0;
+	uint16 version = 0;
+	uint8 numActions = 0;
+
+	reader << magic << version << Seed << NumFrames << numActions;
+	if (reader.IsError() || magic != FileMagic || version != FileVersion || numActions != InputReplay::NumActions)
+		return false;
+
+	ValueTypes.SetNum(numActions);
+	for (EInputActionValueType& valueType : ValueTypes)
+		reader << valueType;
+
+	if (reader.IsError())
+		return false;
+
+	Frames = TArray<uint8>(bytes.GetData() + reader.Tell(), bytes.Num() - reader.Tell());
+
+	Values.SetNum(numActions);
+	for (int32 i = 0; i < numActions; ++i)
+		Values[i] = FInputActionValue(ValueTypes[i], FVector::ZeroVector);
+
+	return true;
+}
+
+void UCF_InputReplaySubsystem::SerializeValue(FArchive& Ar, const EInputActionValueType ValueType, FInputActionValue& Value)
+{
+	FVector axis = Value.Get<FVector>();
+
+	// Stored as floats, one per axis, the precision the input system works with
+	float x = static_cast<float>(axis.X);
+	float y = static_cast<float>(axis.Y);
+	float z = static_cast<float>(axis.Z);
+
+	switch (ValueType)
+	{
+	case EInputActionValueType::Axis3D:	Ar << x << y << z;	break;
+	case EInputActionValueType::Axis2D:	Ar << x << y;		break;
+	case EInputActionValueType::Axis1D:	Ar << x;			break;
+	default:												return;
+	}
+
+	if (Ar.IsLoading())
+		Value = FInputActionValue(ValueType, FVector(x, y, z));
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "InputActionValue.h"
+
+#include "CF_InputReplaySubsystem.generated.h"
+
+// # Project Forwards
+class ACF_Player;
+class UEnhancedInputLocalPlayerSubsystem;
+
+/**
+ * Records the player's Enhanced Input action stream to a compact binary file and plays it back frame by frame:
+ *
+ *   -VHSRecord=<file> [-VHSSeed=<int>]   records every frame's delta time and the actions whose value changed
+ *   -VHSReplay=<file>                    restores the seed, fixes each frame's delta time and injects the actions
+ *
+ * The session seed goes into the header and UCF_RandomSubsystem restores it on replay, so two builds replaying the
+ * same file see the same inputs, the same frame times and the same random draws.
+ */
+UCLASS()
+class VHS_PROJECT_API UCF_InputReplaySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	bool IsReplaying() const { return Mode == EReplayMode::Replay; }
+
+	int32 GetSeed() const { return Seed; }
+
+	/** Reads only the header of a recording */
+	static bool ReadSeed(const FString& Path, int32& OutSeed);
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	enum class EReplayMode : uint8
+	{
+		None,
+		Record,
+		Replay
+	};
+
+	static constexpr uint32 FileMagic = 0x52534856; // VHSR
+	static constexpr uint16 FileVersion = 1;
+
+	EReplayMode Mode = EReplayMode::None;
+	FString FilePath;
+	int32 Seed = 0;
+
+	TWeakObjectPtr<ACF_Player> Player;
+
+	/** Becomes true the frame after the player is found, both modes count frames from there */
+	bool bIsRunning = false;
+
+	/** Frame stream without the header, see RecordFrame */
+	TArray<uint8> Frames;
+	int64 ReadOffset = 0;
+	uint32 NumFrames = 0;
+	uint32 FrameIdx = 0;
+
+	TArray<EInputActionValueType> ValueTypes;
+	TArray<FInputActionValue> Values;
+
+	// -------------------------------------------------------------------------
+
+	UEnhancedInputLocalPlayerSubsystem* GetInputSubsystem() const;
+
+	void Start();
+
+	void RecordFrame(const float DeltaTime);
+
+	/** Decodes the next frame, fixes the next delta time and injects the held actions. False once the stream ends */
+	bool ReplayFrame();
+
+	void StopReplay();
+
+	bool SaveRecording() const;
+
+	bool LoadRecording();
+
+	static void SerializeValue(FArchive& Ar, const EInputActionValueType ValueType, FInputActionValue& Value);
+};
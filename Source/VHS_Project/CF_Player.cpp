@@ -10,23 +10,40 @@
 #include "GameFramework/SpringArmComponent.h"
 #include "GameFramework/PlayerController.h"
 #include "Camera/CameraComponent.h"
-#include "Kismet/KismetSystemLibrary.h"
 #include "Kismet/GameplayStatics.h"
-#include "AssetRegistry/AssetRegistryModule.h"
-#include "AssetRegistry/IAssetRegistry.h"
 #include "Blueprint/UserWidget.h"
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "InputMappingContext.h"
 #include "InputAction.h"
 #include "Engine/LocalPlayer.h"
+#include "Engine/GameInstance.h"
 #include "Materials/MaterialInterface.h"
 
 // # Project Includes
+#include "VHS_Project.h"
 #include "Flashlight.h"
+#include "Dialogue/CF_DialogueBankSubsystem.h"
+#include "Dialogue/CF_DialogueSchedulerComponent.h"
+#include "Components/CF_HeadbobComponent.h"
+#include "Components/CF_CameraPoseComponent.h"
+#include "Components/CF_StaminaComponent.h"
+#include "Components/CF_VHSEffectsComponent.h"
+#include "Subsystems/CF_ClearanceSubsystem.h"
+#include "Subsystems/CF_TriggerSubsystem.h"
+#include "UI/CF_HudPreloadSubsystem.h"
 #include "UI/CF_Widget_VHSOverlay.h"
 #include "Utils/CFUtils.h"
 
+DECLARE_CYCLE_STAT(TEXT("Player BeginPlay"), STAT_VHS_PlayerBeginPlay, STATGROUP_VHS);
+DECLARE_CYCLE_STAT(TEXT("Player Tick"), STAT_VHS_PlayerTick, STATGROUP_VHS);
+DECLARE_CYCLE_STAT(TEXT("Player Headbob"), STAT_VHS_Headbob, STATGROUP_VHS);
+DECLARE_CYCLE_STAT(TEXT("Player CheckBreathing"), STAT_VHS_CheckBreathing, STATGROUP_VHS);
+DECLARE_CYCLE_STAT(TEXT("Player SetupDialogues"), STAT_VHS_SetupDialogues, STATGROUP_VHS);
+DECLARE_CYCLE_STAT(TEXT("Player SetupHUD"), STAT_VHS_SetupHUD, STATGROUP_VHS);
+DECLARE_CYCLE_STAT(TEXT("HUD Create Overlay"), STAT_VHS_CreateOverlay, STATGROUP_VHS);
+DECLARE_CYCLE_STAT(TEXT("HUD Create Blur"), STAT_VHS_CreateBlur, STATGROUP_VHS);
+
 
 ACF_Player::ACF_Player()
 {
@@ -34,6 +51,7 @@ ACF_Player::ACF_Player()
 
 	// Create Components
 	Audio = CreateDefaultSubobject<UAudioComponent>("Audio");
+	Voice = CreateDefaultSubobject<UAudioComponent>("Voice");
 	SpringLeaning = CreateDefaultSubobject<USpringArmComponent>("SpringLeaning");
 	SpringCamera = CreateDefaultSubobject<USpringArmComponent>("SpringCamera");
 	FirstPersonCamera = CreateDefaultSubobject<UCameraComponent>("FPCamera");
@@ -41,11 +59,18 @@ ACF_Player::ACF_Player()
 	CA_Flashlight = CreateDefaultSubobject<UChildActorComponent>("CAFlashlight");
 	CA_Flashlight->SetChildActorClass(AFlashlight::StaticClass());
 
+	DialogueScheduler = CreateDefaultSubobject<UCF_DialogueSchedulerComponent>("DialogueScheduler");
+	CameraHeadbob = CreateDefaultSubobject<UCF_HeadbobComponent>("CameraHeadbob");
+	CameraPose = CreateDefaultSubobject<UCF_CameraPoseComponent>("CameraPose");
+	StaminaComponent = CreateDefaultSubobject<UCF_StaminaComponent>("StaminaComponent");
+	VHSEffects = CreateDefaultSubobject<UCF_VHSEffectsComponent>("VHSEffects");
+
 	// Set Root Component
 	SetRootComponent(GetCapsuleComponent());
 
 	// Set Attachments
 	Audio->SetupAttachment(GetRootComponent());
+	Voice->SetupAttachment(GetRootComponent());
 	SpringLeaning->SetupAttachment(GetRootComponent());
 	SpringCamera->SetupAttachment(SpringLeaning);
 	FirstPersonCamera->SetupAttachment(SpringCamera);
@@ -58,6 +83,8 @@ ACF_Player::ACF_Player()
 	GetCapsuleComponent()->SetCapsuleHalfHeight(HalfHeightStanding);
 
 	Audio->SetRelativeLocation(FVector(0, 0, 60));
+	Voice->SetRelativeLocation(FVector(0, 0, 60));
+	Voice->bAutoActivate = false;
 
 	SpringLeaning->SetRelativeLocation(FVector(0, 0, 30));
 	SpringLeaning->SetRelativeRotation(FRotator(-90, 0, 0));
@@ -74,85 +101,16 @@ ACF_Player::ACF_Player()
 	FirstPersonCamera->SetAspectRatioAxisConstraint(EAspectRatioAxisConstraint::AspectRatio_MAX);
 	FirstPersonCamera->bOverrideAspectRatioAxisConstraint = true;
 	FirstPersonCamera->bUseFieldOfViewForLOD = false;
-
-	// Initialize Timelines
-	TL_Crouch = CreateDefaultSubobject<UTimelineComponent>("TL_Crouch");
-	TL_Lean = CreateDefaultSubobject<UTimelineComponent>("TL_Lean");
-	TL_Zoom = CreateDefaultSubobject<UTimelineComponent>("TL_Zoom");
 }
 
 void ACF_Player::BeginPlay()
 {
+	VHS_SCOPE(PlayerBeginPlay);
+
 	Super::BeginPlay();
 
 	// Camera Postprocess materials
-	TArray<FWeightedBlendable> blendables;
-	for (auto* material : PostprocessMaterials)
-	{
-		FWeightedBlendable blendable;
-		blendable.Object = material;
-		blendable.Weight = 1.f;	
-	}
-	FirstPersonCamera->PostProcessSettings.WeightedBlendables = blendables;
-
-	// Timelines setup
-	// - Timeline CROUCH
-	TimelineCrouchFloatFn.BindUFunction(this, FName("HandleTimelineCrouchAlpha"));
-	TimelineCrouchFloatFn.BindUFunction(this, FName("HandleTimelineCrouchRotYaw"));
-	TimelineCrouchFloatFn.BindUFunction(this, FName("HandleTimelineCrouchUpDown"));
-
-	UCurveFloat* CrouchCurveAlpha = NewObject<UCurveFloat>(this, UCurveFloat::StaticClass(), TEXT("FloatCurve1"));
-	FKeyHandle KH_CrouchAlphaFirst;
-	CrouchCurveAlpha->FloatCurve.SetKeyInterpMode(KH_CrouchAlphaFirst, ERichCurveInterpMode::RCIM_Cubic);
-
-	CrouchCurveAlpha->FloatCurve.AddKey(0.f, 0.f, false, KH_CrouchAlphaFirst);
-	CrouchCurveAlpha->FloatCurve.AddKey(1.f, 1.f);
-	TL_Crouch->AddInterpFloat(CrouchCurveAlpha, TimelineCrouchFloatFn, FName("Alpha"));
-
-	UCurveFloat* CrouchCurveRotYaw = NewObject<UCurveFloat>(this, UCurveFloat::StaticClass(), TEXT("FloatCurve2"));
-	FKeyHandle KH_CrouchRotYawFirst;
-	FKeyHandle KH_CrouchRotYawSecond;
-	FKeyHandle KH_CrouchRotYawThird;
-	CrouchCurveRotYaw->FloatCurve.SetKeyInterpMode(KH_CrouchRotYawFirst, ERichCurveInterpMode::RCIM_Cubic);
-	CrouchCurveRotYaw->FloatCurve.SetKeyInterpMode(KH_CrouchRotYawSecond, ERichCurveInterpMode::RCIM_Cubic);
-	CrouchCurveRotYaw->FloatCurve.SetKeyInterpMode(KH_CrouchRotYawThird, ERichCurveInterpMode::RCIM_Cubic);
-
-	CrouchCurveRotYaw->FloatCurve.AddKey(0.f, 0.f, false, KH_CrouchRotYawFirst);
-	CrouchCurveRotYaw->FloatCurve.AddKey(.25f, -1.f, false, KH_CrouchRotYawFirst);
-	CrouchCurveRotYaw->FloatCurve.AddKey(.75f, 1.f, false, KH_CrouchRotYawFirst);
-	CrouchCurveRotYaw->FloatCurve.AddKey(1.f, 0.f);
-	
-	UCurveFloat* CrouchCurveUpDown = NewObject<UCurveFloat>(this, UCurveFloat::StaticClass(), TEXT("FloatCurve3"));
-	FKeyHandle KH_CrouchUpDownFirst;
-	FKeyHandle KH_CrouchUpDownSecond;
-	CrouchCurveUpDown->FloatCurve.SetKeyInterpMode(KH_CrouchUpDownFirst, ERichCurveInterpMode::RCIM_Cubic);
-	CrouchCurveUpDown->FloatCurve.SetKeyInterpMode(KH_CrouchUpDownSecond, ERichCurveInterpMode::RCIM_Cubic);
-
-	CrouchCurveUpDown->FloatCurve.AddKey(0.f, 0.f, false, KH_CrouchUpDownFirst);
-	CrouchCurveUpDown->FloatCurve.AddKey(.5f, -7.54f, false, KH_CrouchUpDownSecond);
-	CrouchCurveUpDown->FloatCurve.AddKey(1.f, 0.f);
-
-	TL_Crouch->AddInterpFloat(CrouchCurveAlpha, TimelineCrouchFloatFn, FName("Alpha"));
-	TL_Crouch->AddInterpFloat(CrouchCurveRotYaw, TimelineCrouchFloatFn, FName("RotYaw"));
-	TL_Crouch->AddInterpFloat(CrouchCurveUpDown, TimelineCrouchFloatFn, FName("UpDown"));
-
-	// - Timeline LEAN
-	TimelineLeanFloatFn.BindUFunction(this, FName("HandleTimelineLeanAlpha"));
-
-	UCurveFloat* LeanCurve = NewObject<UCurveFloat>(this, UCurveFloat::StaticClass(), TEXT("FloatCurve4"));
-	LeanCurve->FloatCurve.AddKey(0.f, 0.f);
-	LeanCurve->FloatCurve.AddKey(1.f, 1.f);
-
-	TL_Lean->AddInterpFloat(LeanCurve, TimelineLeanFloatFn, FName("Alpha"));
-
-	// - Timeline ZOOM
-	TimelineZoomFloatFn.BindUFunction(this, FName("HandleTimelineZoomAlpha"));
-
-	UCurveFloat* ZoomCurve = NewObject<UCurveFloat>(this, UCurveFloat::StaticClass(), TEXT("FloatCurve5"));
-	ZoomCurve->FloatCurve.AddKey(0.f, 0.f);
-	ZoomCurve->FloatCurve.AddKey(1.f, 1.f);
-
-	TL_Zoom->AddInterpFloat(ZoomCurve, TimelineZoomFloatFn, FName("Alpha"));
+	VHSEffects->Setup(FirstPersonCamera, PostprocessMaterials);
 
 	// Enhanced Inputs setup
 	if (auto* pc = Cast<APlayerController>(GetController()))
@@ -165,12 +123,30 @@ void ACF_Player::BeginPlay()
 	}
 
 	// Setups
+	CameraPose->Setup(FirstPersonCamera, SpringLeaning, GetCapsuleComponent(), HalfHeightStanding, HalfHeightCrouch);
+	CameraPose->OnZoomLevelChanged.AddUObject(this, &ACF_Player::HandleZoomLevelChanged);
+
 	SetupHUD();
 	SetupCharacterLeaning();
 	SetupDialogues();
 
-	TL_Crouch->SetPlayRate(1.f / CrouchDuration);
-	CameraRotation = FirstPersonCamera->GetRelativeRotation();
+	CameraHeadbob->Setup(CS_Idle, CS_Walk, CS_Run);
+
+	StaminaComponent->Setup(MaxStamina, MaxSprintTime, TimeToRegenStamina, DelayStaminaRegen);
+	StaminaComponent->OnStaminaDepleted.AddUObject(this, &ACF_Player::HandleStaminaDepleted);
+
+	DialogueScheduler->Setup(Voice);
+	DialogueScheduler->OnSpeakingChanged.AddUObject(this, &ACF_Player::HandleSpeakingChanged);
+
+	if (auto* clearance = GetWorld()->GetSubsystem<UCF_ClearanceSubsystem>())
+	{
+		clearance->Register(this, HalfHeightStanding);
+		DH_ClearanceUpdated = clearance->OnClearanceUpdated.AddUObject(this, &ACF_Player::HandleClearanceUpdated);
+	}
+
+	if (auto* triggers = GetWorld()->GetSubsystem<UCF_TriggerSubsystem>())
+		triggers->RegisterActor(this, ETriggerActor::Player, GetCapsuleComponent()->GetScaledCapsuleRadius());
+
 	StartBreathing();
 
 	// Flashlight Child Actor
@@ -178,12 +154,33 @@ void ACF_Player::BeginPlay()
 		Flashlight = Cast<AFlashlight>(ChildActor);
 }
 
+void ACF_Player::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (auto* bank = UGameInstance::GetSubsystem<UCF_DialogueBankSubsystem>(GetGameInstance()))
+		bank->OnDialoguesReady.Remove(DH_DialoguesReady);
+
+	if (auto* clearance = GetWorld()->GetSubsystem<UCF_ClearanceSubsystem>())
+	{
+		clearance->OnClearanceUpdated.Remove(DH_ClearanceUpdated);
+		clearance->Unregister(this);
+	}
+
+	if (auto* triggers = GetWorld()->GetSubsystem<UCF_TriggerSubsystem>())
+		triggers->UnregisterActor(this);
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void ACF_Player::Tick(float DeltaTime)
 {
+	VHS_SCOPE(PlayerTick);
+
 	Super::Tick(DeltaTime);
 
 	Headbob();
 	CheckBreathing();
+
+	BreathingParams.Flush();
 }
 
 void ACF_Player::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -210,34 +207,78 @@ void ACF_Player::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent
 	}
 }
 
+UInputAction* ACF_Player::GetInputAction(const EPlayerAction Action) const
+{
+	switch (Action)
+	{
+	case EPlayerAction::Look:		return IA_Look;
+	case EPlayerAction::Move:		return IA_Move;
+	case EPlayerAction::Sprint:		return IA_Sprint;
+	case EPlayerAction::Jump:		return IA_Jump;
+	case EPlayerAction::Crouch:		return IA_Crouch;
+	case EPlayerAction::LeanLeft:	return IA_LeanLeft;
+	case EPlayerAction::LeanRight:	return IA_LeanRight;
+	case EPlayerAction::Zoom:		return IA_Zoom;
+	case EPlayerAction::Flashlight:	return IA_Flashlight;
+	default:						return nullptr;
+	}
+}
+
+bool ACF_Player::IsFlashlightOn() const
+{
+	return Flashlight && Flashlight->IsLightOn();
+}
+
+FVector ACF_Player::GetHeadLocation() const
+{
+	return FirstPersonCamera ? FirstPersonCamera->GetComponentLocation() : GetActorLocation();
+}
+
+float ACF_Player::GetStamina() const
+{
+	return StaminaComponent ? StaminaComponent->GetStamina() : 0.f;
+}
+
 void ACF_Player::Headbob()
 {
-	auto* pc = GetController<APlayerController>();
-	if (!pc)
-		return;
+	VHS_SCOPE(Headbob);
 
 	const float Speed = GetVelocity().Length();
-	TSubclassOf<UCameraShakeBase> camShake = !(Speed > 0 && CanJump()) ? CS_Idle : (Speed < SprintSpeed) ? CS_Walk : CS_Run;
+	const EHeadbobBand band = !(Speed > 0 && CanJump()) ? EHeadbobBand::Idle : (Speed < SprintSpeed) ? EHeadbobBand::Walk : EHeadbobBand::Run;
 
-	if(camShake)
-		pc->ClientStartCameraShake(camShake, 1.f, ECameraShakePlaySpace::CameraLocal);
+	CameraHeadbob->SetBand(band);
 }
 
 void ACF_Player::ProcessCrouch()
 {
 	if (bIsCrouching)
-		if (!CanUncrouch())
+	{
+		const EClearance clearance = GetUncrouchClearance();
+
+		// No result for this position yet, HandleClearanceUpdated finishes the uncrouch
+		bIsUncrouchPending = clearance == EClearance::Unknown;
+		if (clearance != EClearance::Clear)
 			return;
+	}
 
 	bIsCrouching = !bIsCrouching;
 
+	if (auto* clearance = GetWorld()->GetSubsystem<UCF_ClearanceSubsystem>())
+		clearance->SetActive(this, bIsCrouching);
+
 	UpdateMovementSpeed();
 }
 
 void ACF_Player::StartBreathing()
 {
-	Audio->SetIntParameter(FName("IsSpeaking"), 0);
-	Audio->SetIntParameter(FName("Breathing"), 0);
+	BreathingParams.Setup(Audio);
+	AP_IsSpeaking = BreathingParams.AddInt(FName("IsSpeaking"));
+	AP_Breathing = BreathingParams.AddInt(FName("Breathing"));
+
+	BreathingParams.SetInt(AP_IsSpeaking, bIsSpeaking);
+	BreathingParams.SetInt(AP_Breathing, 0);
+	BreathingParams.Flush();
+
 	Audio->Play();
 }
 
@@ -245,37 +286,19 @@ void ACF_Player::StartBreathing()
 
 void ACF_Player::CalcLeanDirection()
 {
-	if (!TL_Lean)
-		return;
-
-	LeanStart = LeanDirection * TL_Lean->GetPlaybackPosition();
+	LeanStart = LeanDirection * CameraPose->GetPosition(ECameraPoseChannel::Lean);
 	LeanDirection = -static_cast<int8>(bIsLeaningLeft) + static_cast<int8>(bIsLeaningRight);
 
-	TL_Lean->PlayFromStart();
+	CameraPose->SetLean(LeanStart, LeanDirection, LeanDistance);
+	CameraPose->PlayFromStart(ECameraPoseChannel::Lean);
 }
 
-void ACF_Player::ConsumeStamina()
+void ACF_Player::HandleStaminaDepleted()
 {
-	Stamina -= MaxStamina / (MaxSprintTime * TimerTickRate * 100);
-	Stamina = FMath::Clamp(Stamina, 0, MaxStamina);
-
-	if (Stamina == 0.f)
-	{
-		PauseTimer(this, TH_ConsumeStamina);
-
-		bIsSprinting = false;
+	bIsSprinting = false;
+	StaminaComponent->StartRegen();
 
-		UpdateMovementSpeed();
-	}
-}
-
-void ACF_Player::RegenStamina()
-{
-	Stamina += MaxStamina / (TimeToRegenStamina * TimerTickRate * 100.f);
-	Stamina = FMath::Clamp(Stamina, 0, MaxStamina);
-
-	if (Stamina == MaxStamina)
-		ClearTimer(this, TH_RegenStamina);
+	UpdateMovementSpeed();
 }
 
 void ACF_Player::UpdateMovementSpeed()
@@ -285,22 +308,16 @@ void ACF_Player::UpdateMovementSpeed()
 	const float newMaxSpeed = (bIsSprinting && bIsCrouching) ? FastCrouchSpeed : bIsSprinting ? SprintSpeed : bIsCrouching ? CrouchSpeed : WalkSpeed;
 	CMC->MaxWalkSpeed = newMaxSpeed;
 
-	if (!TL_Crouch)
-		return;
-
 	if (bIsCrouching)
-		TL_Crouch->Play();
+		CameraPose->Play(ECameraPoseChannel::Crouch);
 	else
-		TL_Crouch->Reverse();
+		CameraPose->Reverse(ECameraPoseChannel::Crouch);
 }
 
-void ACF_Player::HandleTimelineZoomAlpha(float Alpha)
+void ACF_Player::HandleZoomLevelChanged(int32 ZoomLevel)
 {
-	const float FOV = FMath::Lerp(65.f, 30.f, Alpha);
-	FirstPersonCamera->SetFieldOfView(FOV);
-
 	if(HUDOverlay)
-		HUDOverlay->UpdateZoom(FMath::RoundToInt(Alpha * 2 + 2));
+		HUDOverlay->UpdateZoom(ZoomLevel);
 }
 
 void ACF_Player::InputLook(const FInputActionValue& Value)
@@ -327,7 +344,7 @@ void ACF_Player::InputSprint(const FInputActionValue& Value)
 	{
 		ChangeSprintState(false);
 	}
-	else if (Stamina > 0)
+	else if (StaminaComponent->GetStamina() > 0)
 	{
 		ChangeSprintState(true);
 	}
@@ -355,9 +372,9 @@ void ACF_Player::InputLeanRight(const FInputActionValue& Value)
 void ACF_Player::InputZoom(const FInputActionValue& Value)
 {
 	if (Value.Get<bool>())
-		TL_Zoom->Play();
+		CameraPose->Play(ECameraPoseChannel::Zoom);
 	else
-		TL_Zoom->Reverse();
+		CameraPose->Reverse(ECameraPoseChannel::Zoom);
 }
 
 void ACF_Player::InputFlashlight(const FInputActionValue& Value)
@@ -366,16 +383,6 @@ void ACF_Player::InputFlashlight(const FInputActionValue& Value)
 	PlaySFX(this, SFX_Flashlight, Flashlight->GetActorLocation());
 }
 
-void ACF_Player::StartStaminaConsumption()
-{
-	SetupTimerSwitch(this, TH_ConsumeStamina, TimerTickRate, &ACF_Player::ConsumeStamina, &TH_RegenStamina);
-}
-
-void ACF_Player::StartStaminaRegen()
-{
-	SetupTimerSwitch(this, TH_RegenStamina, TimerTickRate, &ACF_Player::RegenStamina, &TH_ConsumeStamina);
-}
-
 void ACF_Player::ChangeSprintState(const bool bInState)
 {
 	if (bInState == bIsSprinting)
@@ -383,9 +390,9 @@ void ACF_Player::ChangeSprintState(const bool bInState)
 
 	bIsSprinting = bInState;
 	if (bIsSprinting)
-		StartStaminaConsumption();
+		StaminaComponent->StartConsumption();
 	else
-		StartStaminaRegen();
+		StaminaComponent->StartRegen();
 
 	UpdateMovementSpeed();
 }
@@ -398,75 +405,34 @@ void ACF_Player::InputJump()
 		Jump();
 }
 
-void ACF_Player::HandleTimelineLeanAlpha(float Alpha)
-{
-	float angle = FMath::Lerp(LeanStart, LeanDirection, Alpha);
-	float angleLength = angle * LeanDistance;
-
-	SpringLeaning->SocketOffset = FVector(0, angleLength, 0);
-	SpringLeaning->TargetArmLength = 30.f - (angle * 10);
-
-	CameraRotation.Roll = angleLength * .1f;
-	FirstPersonCamera->SetRelativeRotation(CameraRotation);
-}
-
-void ACF_Player::HandleTimelineCrouchAlpha(float Alpha)
-{
-	GetCapsuleComponent()->SetCapsuleHalfHeight(FMath::Lerp(HalfHeightStanding, HalfHeightCrouch, Alpha));
-}
-void ACF_Player::HandleTimelineCrouchRotYaw(float RotYaw)
-{
-	CameraRotation.Yaw = RotYaw;
-	FirstPersonCamera->SetRelativeRotation(CameraRotation);
-}
-void ACF_Player::HandleTimelineCrouchUpDown(float UpDown)
+EClearance ACF_Player::GetUncrouchClearance() const
 {
-	CameraRotation.Pitch = UpDown;
-	FirstPersonCamera->SetRelativeRotation(CameraRotation);
+	const auto* clearance = GetWorld()->GetSubsystem<UCF_ClearanceSubsystem>();
+	return clearance ? clearance->GetClearance(this) : EClearance::Unknown;
 }
 
-bool ACF_Player::CanUncrouch() const
+void ACF_Player::HandleClearanceUpdated(ACharacter* Character, EClearance Clearance)
 {
-	const FVector location = GetActorLocation() + FVector(0, 0, HalfHeightStanding - GetCapsuleComponent()->GetScaledCapsuleHalfHeight());
-	const float radius = GetCapsuleComponent()->GetScaledCapsuleRadius();
-	FHitResult hit;
+	if (Character != this || !bIsUncrouchPending)
+		return;
 
-	UKismetSystemLibrary::CapsuleTraceSingle(this, location, location, radius, HalfHeightStanding, ETraceTypeQuery::TraceTypeQuery1, false, {}, EDrawDebugTrace::None, hit, true);
+	bIsUncrouchPending = false;
 
-	return !hit.bBlockingHit;
+	if (Clearance == EClearance::Clear && bIsCrouching)
+		ProcessCrouch();
 }
 
 
-TArray<USoundWave*> ACF_Player::GetWavesInFolder(const FString& FolderName, const ELanguage& Language) const
-{
-	TArray<USoundWave*> waves;
-
-	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
-	IAssetRegistry& AssetRegistry = AssetRegistryModule.Get();
-
-	const FString fullPath = FString::Printf(TEXT("%s%s/%s"), *DialoguesPath, *UEnum::GetValueAsString<ELanguage>(Language), *FolderName);
-	TArray<FAssetData> data;
-	AssetRegistry.GetAssetsByPath(FName(*fullPath), data, false, false);
-
-	for (const auto asset : data)
-	{
-		if (auto* wave = Cast<USoundWave>(asset.GetAsset()))
-			waves.Add(wave);
-	}
-
-	Shuffle(waves);
-
-	return waves;
-}
-
 void ACF_Player::CheckBreathing()
 {
+	VHS_SCOPE(CheckBreathing);
+
 	const FVector velocity = GetVelocity();
 	const float speed = FVector2D(velocity.X, velocity.Y).Length();
 
 	const float volumeMultiplier = bIsSprinting ? 1.f : FMath::Clamp((speed / 2) / SprintSpeed, 0, 1);
 
-	Audio->SetVolumeMultiplier(volumeMultiplier);
+	BreathingParams.SetVolumeMultiplier(volumeMultiplier);
 }
 
 void ACF_Player::FlickerFlashlight(const bool bStart)
@@ -479,40 +445,85 @@ void ACF_Player::FlickerFlashlight(const bool bStart)
 
 void ACF_Player::SetupDialogues()
 {
-	for (auto& folder : DialogueList)
-	{
-		Dialogues.Add(folder, FST_Dialogue(GetWavesInFolder(folder, ELanguage::es), GetWavesInFolder(folder, ELanguage::en)));
-	}
+	VHS_SCOPE(SetupDialogues);
 
+	auto* bank = UGameInstance::GetSubsystem<UCF_DialogueBankSubsystem>(GetGameInstance());
+	if (!bank)
+		return;
+
+	DH_DialoguesReady = bank->OnDialoguesReady.AddUObject(this, &ACF_Player::HandleDialoguesReady);
+	bank->RegisterLayout(DialoguesPath, DialogueList);
+	bank->PrimeState(DanielState);
+}
+
+void ACF_Player::HandleDialoguesReady()
+{
 	bAreDialoguesReady = true;
 	OnDialoguesReady.Broadcast();
 }
 
+void ACF_Player::HandleSpeakingChanged(bool bInIsSpeaking)
+{
+	bIsSpeaking = bInIsSpeaking;
+	BreathingParams.SetInt(AP_IsSpeaking, bIsSpeaking);
+}
+
+bool ACF_Player::PlayDialogue(const FString& Folder, const bool bInterrupt)
+{
+	return DialogueScheduler->QueueDialogue(Folder, DanielState, bInterrupt);
+}
+
+void ACF_Player::SetDanielState(const EDanielState NewState)
+{
+	DanielState = NewState;
+
+	if (auto* bank = UGameInstance::GetSubsystem<UCF_DialogueBankSubsystem>(GetGameInstance()))
+		bank->PrimeState(DanielState);
+}
+
 void ACF_Player::SetupCharacterLeaning()
 {
-	if(TL_Lean)
-		TL_Lean->SetPlayRate(1.f / LeanDuration);
+	CameraPose->SetPlayRate(ECameraPoseChannel::Lean, 1.f / LeanDuration);
+	CameraPose->SetPlayRate(ECameraPoseChannel::Crouch, 1.f / CrouchDuration);
 
 	UpdateMovementSpeed();
 }
 
 void ACF_Player::SetupHUD()
 {
+	VHS_SCOPE(SetupHUD);
+
+	auto* preload = UGameInstance::GetSubsystem<UCF_HudPreloadSubsystem>(GetGameInstance());
+	if (!preload)
+		return;
+
+	preload->RequestWidgetClass(VHSOverlayClass, FOnHudWidgetClassLoaded::CreateUObject(this, &ACF_Player::HandleOverlayClassLoaded));
+	preload->RequestWidgetClass(VHSBlurClass, FOnHudWidgetClassLoaded::CreateUObject(this, &ACF_Player::HandleBlurClassLoaded));
+}
+
+void ACF_Player::HandleOverlayClassLoaded(TSubclassOf<UUserWidget> WidgetClass)
+{
+	VHS_SCOPE(CreateOverlay);
+
 	auto* pc = GetController<APlayerController>();
-	if (!pc)
+	if (!pc || !WidgetClass || HUDOverlay)
 		return;
 
-	if (VHSOverlayClass)
-	{
-		HUDOverlay = CreateWidget<UCF_Widget_VHSOverlay>(pc, VHSOverlayClass->StaticClass());
-		if(HUDOverlay)
-			HUDOverlay->AddToViewport();
-	}
+	HUDOverlay = CreateWidget<UCF_Widget_VHSOverlay>(pc, WidgetClass);
+	if(HUDOverlay)
+		HUDOverlay->AddToViewport(0);
+}
 
-	if (VHSBlurClass)
-	{
-		UUserWidget* blur = CreateWidget<UUserWidget>(pc, VHSBlurClass->StaticClass());
-		if(blur)
-			blur->AddToViewport();
-	}
+void ACF_Player::HandleBlurClassLoaded(TSubclassOf<UUserWidget> WidgetClass)
+{
+	VHS_SCOPE(CreateBlur);
+
+	auto* pc = GetController<APlayerController>();
+	if (!pc || !WidgetClass)
+		return;
+
+	// Loads can finish in any order, the blur always stays above the overlay
+	UUserWidget* blur = CreateWidget<UUserWidget>(pc, WidgetClass);
+	if(blur)
+		blur->AddToViewport(1);
 }
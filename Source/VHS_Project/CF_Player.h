@@ -2,7 +2,10 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
-#include "Components/TimelineComponent.h"
+
+#include "Audio/CF_AudioParamBinder.h"
+#include "Dialogue/CF_DialogueTypes.h"
+#include "Utils/CFShuffleBag.h"
 
 #include "CF_Player.generated.h"
 
@@ -19,37 +22,26 @@ class UInputAction;
 
 // # Project Forwards
 class AFlashlight;
-
-DECLARE_MULTICAST_DELEGATE(FOnDialoguesReady)
-
-UENUM(BlueprintType)
-enum class ELanguage : uint8
-{
-	es = 0	UMETA(DisplayName = "es"),
-	en = 1	UMETA(DisplayName = "en")
-};
-
-UENUM(BlueprintType)
-enum class EDanielState : uint8
+class UCF_DialogueSchedulerComponent;
+class UCF_HeadbobComponent;
+class UCF_CameraPoseComponent;
+class UCF_StaminaComponent;
+class UCF_VHSEffectsComponent;
+enum class EClearance : uint8;
+
+/** Every action bound in SetupPlayerInputComponent, for code that drives or observes the player's input */
+enum class EPlayerAction : uint8
 {
-	State2 = 0		UMETA(DisplayName = "State 2"),
-	State3 = 1		UMETA(DisplayName = "State 3"),
-	State4 = 2		UMETA(DisplayName = "State 4"),
-	State5 = 3		UMETA(DisplayName = "State 5"),
-	State6 = 4		UMETA(DisplayName = "State 6"),
-};
-
-USTRUCT(BlueprintType)
-struct FST_Dialogue
-{
-	GENERATED_BODY()
-
-	UPROPERTY() TArray<USoundWave*> es = {};
-	UPROPERTY() TArray<USoundWave*> en = {};
-
-	FST_Dialogue() {}
-
-	FST_Dialogue(const TArray<USoundWave*> inES, const TArray<USoundWave*> inEN) : es(inES), en(inEN) {}
+	Look,
+	Move,
+	Sprint,
+	Jump,
+	Crouch,
+	LeanLeft,
+	LeanRight,
+	Zoom,
+	Flashlight,
+	MAX
 };
 
 UCLASS(Blueprintable)
@@ -65,23 +57,35 @@ protected:
 	
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	FOnDialoguesReady OnDialoguesReady;
 
 	const float HalfHeightCrouch = 20.f;
 	const float HalfHeightStanding = 90.f;
-	FRotator CameraRotation;
 
 	// SFX --->
 
+	/** Breathing layers of Audio, flushed once at the end of Tick */
+	FCF_AudioParamBinder BreathingParams;
+	int32 AP_IsSpeaking = INDEX_NONE;
+	int32 AP_Breathing = INDEX_NONE;
+
 	UPROPERTY(EditDefaultsOnly, Category = "CustomProperties | SFX") USoundBase* SFX_Flashlight;
 
 	// Components --->
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly) UAudioComponent* Audio;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly) UAudioComponent* Voice;
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly) USpringArmComponent* SpringLeaning;
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly) USpringArmComponent* SpringCamera;
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly) UCameraComponent* FirstPersonCamera;
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly) UChildActorComponent* CA_Flashlight;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly) UCF_DialogueSchedulerComponent* DialogueScheduler;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly) UCF_HeadbobComponent* CameraHeadbob;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly) UCF_CameraPoseComponent* CameraPose;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly) UCF_StaminaComponent* StaminaComponent;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly) UCF_VHSEffectsComponent* VHSEffects;
 
 	// Properties --->
 
@@ -114,6 +118,10 @@ protected:
 
 	bool bIsCrouching = false;
 
+	/** Uncrouch requested before the clearance service had a result for the current position */
+	bool bIsUncrouchPending = false;
+	FDelegateHandle DH_ClearanceUpdated;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Controls | Movement")
 	float WalkSpeed = 230.f;
 
@@ -129,9 +137,6 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Controls | Movement")
 	float CrouchDuration = 1.1f;
 
-	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Stats | Stamina")
-	float Stamina = 100.f;
-
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Stats | Stamina")
 	float MaxStamina = 100.f;
 
@@ -139,9 +144,6 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Stats | Stamina")
 	float MaxSprintTime = 7.f;
 
-	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Stats | Stamina")
-	float TimerTickRate = 0.1f;
-
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Stats | Stamina")
 	float DelayStaminaRegen = 2.f;
 
@@ -155,10 +157,9 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Dialogues")
 	TArray<FString> DialogueList = { "Intro", "BackToCar", "CarReached", "NeedMoreRecord", "State_Extra1", "State2", "State3", "State4", "State4B", "State5", "State6", "State6B" };
 
-	TMap<FString, FST_Dialogue> Dialogues;
-	TArray<FString> DialoguesStack;
 	bool bIsSpeaking = false;
 	bool bAreDialoguesReady = false;
+	FDelegateHandle DH_DialoguesReady;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	EDanielState DanielState = EDanielState::State2;
 
@@ -196,63 +197,61 @@ protected:
 	UFUNCTION() void InputZoom(const FInputActionValue& Value);
 	UFUNCTION() void InputFlashlight(const FInputActionValue& Value);
 
-	UFUNCTION() void StartStaminaConsumption();
-	UFUNCTION() void StartStaminaRegen();
-
 	void ChangeSprintState(const bool bInState);
 
+	void HandleStaminaDepleted();
+
 	// -------------------------------------------------------------------------
 
 	// HUD --->
+	UPROPERTY(EditDefaultsOnly, Category = "CustomProperties | HUD")
 	TSoftClassPtr<UCF_Widget_VHSOverlay> VHSOverlayClass;
-	UCF_Widget_VHSOverlay* HUDOverlay;
 
+	UPROPERTY(EditDefaultsOnly, Category = "CustomProperties | HUD")
 	TSoftClassPtr<UUserWidget> VHSBlurClass;
 
-	// Timelines --->
-	UTimelineComponent* TL_Lean;
-	FOnTimelineFloat TimelineLeanFloatFn{};
-	UFUNCTION() void HandleTimelineLeanAlpha(float Alpha);
-
-	UTimelineComponent* TL_Crouch;
-	FOnTimelineFloat TimelineCrouchFloatFn;
-	UFUNCTION() void HandleTimelineCrouchAlpha(float Alpha);
-	UFUNCTION() void HandleTimelineCrouchRotYaw(float RotYaw);
-	UFUNCTION() void HandleTimelineCrouchUpDown(float UpDown);
-
-	UTimelineComponent* TL_Zoom;
-	FOnTimelineFloat TimelineZoomFloatFn{};
-	UFUNCTION() void HandleTimelineZoomAlpha(float Alpha);
-
-	// Timer handles --->
-	FTimerHandle TH_ConsumeStamina;
-	FTimerHandle TH_RegenStamina;
+	UPROPERTY() UCF_Widget_VHSOverlay* HUDOverlay = nullptr;
 
 	// -------------------------------------------------------------------------------
 
 	void CalcLeanDirection();
 
-	void ConsumeStamina();
-
-	void RegenStamina();
-
 	void UpdateMovementSpeed();
 
-	bool CanUncrouch() const;
+	/** Cached result of the clearance service, never waits on a physics query */
+	EClearance GetUncrouchClearance() const;
 
-	TArray<USoundWave*> GetWavesInFolder(const FString& FolderName, const ELanguage& Language) const;
+	void HandleClearanceUpdated(ACharacter* Character, EClearance Clearance);
 
 	void CheckBreathing();
 
 	UFUNCTION(BlueprintCallable)
 	void FlickerFlashlight(const bool bStart);
 
+	/** Queues a line of Folder with the priority of the current DanielState */
+	UFUNCTION(BlueprintCallable)
+	bool PlayDialogue(const FString& Folder, const bool bInterrupt = false);
+
+	UFUNCTION(BlueprintCallable)
+	void SetDanielState(const EDanielState NewState);
+
 	void SetupDialogues();
 
+	void HandleDialoguesReady();
+
+	void HandleSpeakingChanged(bool bInIsSpeaking);
+
+	void HandleZoomLevelChanged(int32 ZoomLevel);
+
 	void SetupCharacterLeaning();
 
+	/** Widgets are created once their classes are resident, see UCF_HudPreloadSubsystem */
 	void SetupHUD();
 
+	void HandleOverlayClassLoaded(TSubclassOf<UUserWidget> WidgetClass);
+
+	void HandleBlurClassLoaded(TSubclassOf<UUserWidget> WidgetClass);
+
 	void Headbob();
 
 	//
@@ -267,16 +266,27 @@ public:
 
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
+	UInputAction* GetInputAction(const EPlayerAction Action) const;
+
+	UInputMappingContext* GetInputMappingContext() const { return IMC; }
+
+	bool IsPlayerCrouching() const { return bIsCrouching; }
+
+	bool IsPlayerLeaning() const { return bIsLeaningLeft || bIsLeaningRight; }
+
+	bool IsFlashlightOn() const;
+
+	/** Camera location, includes the lean and crouch offsets */
+	FVector GetHeadLocation() const;
+
+	/** Replaces the old Stamina float, which is now evaluated on demand by the stamina component */
+	UFUNCTION(BlueprintPure, Category = "CustomProperties | Stats | Stamina")
+	float GetStamina() const;
+
 	template <typename T>
-	static void Shuffle(TArray<T>& inArray)
+	static void Shuffle(TArray<T>& inArray, FCF_RandomStream& Stream)
 	{
-		const int32 lastIdx = inArray.Num() - 1;
-		for (int32 i = 0; i < lastIdx; ++i)
-		{
-			const int32 SwapIdx = FMath::RandRange(i, lastIdx);
-			if (i != SwapIdx)
-				inArray.Swap(i, SwapIdx);
-		}
+		ShuffleArray(inArray, Stream);
 	}
 
 	static FTimerManager* GetTimerManager(UObject* inWCO)
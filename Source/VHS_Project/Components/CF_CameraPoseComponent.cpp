@@ -0,0 +1,193 @@
+#include "CF_CameraPoseComponent.h"
+
+// # Engine Includes
+#include "Camera/CameraComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/SpringArmComponent.h"
+
+// # Project Includes
+#include "VHS_Project.h"
+
+DECLARE_CYCLE_STAT(TEXT("Camera Pose Tick"), STAT_VHS_CameraPoseTick, STATGROUP_VHS);
+
+namespace CameraPoseCurves
+{
+	struct FKey
+	{
+		float Time;
+		float Value;
+	};
+
+	struct FCurve
+	{
+		const FKey* Keys;
+		int32 Num;
+	};
+
+	constexpr FKey CrouchAlphaKeys[] = { { 0.f, 0.f }, { 1.f, 1.f } };
+	constexpr FKey CrouchRotYawKeys[] = { { 0.f, 0.f }, { .25f, -1.f }, { .75f, 1.f }, { 1.f, 0.f } };
+	constexpr FKey CrouchUpDownKeys[] = { { 0.f, 0.f }, { .5f, -7.54f }, { 1.f, 0.f } };
+	constexpr FKey LinearKeys[] = { { 0.f, 0.f }, { 1.f, 1.f } };
+
+	constexpr FCurve CrouchAlpha = { CrouchAlphaKeys, UE_ARRAY_COUNT(CrouchAlphaKeys) };
+	constexpr FCurve CrouchRotYaw = { CrouchRotYawKeys, UE_ARRAY_COUNT(CrouchRotYawKeys) };
+	constexpr FCurve CrouchUpDown = { CrouchUpDownKeys, UE_ARRAY_COUNT(CrouchUpDownKeys) };
+	constexpr FCurve Lean = { LinearKeys, UE_ARRAY_COUNT(LinearKeys) };
+	constexpr FCurve Zoom = { LinearKeys, UE_ARRAY_COUNT(LinearKeys) };
+
+	/** Same shape as the FRichCurves the timelines used, whose keys were all linear */
+	float Evaluate(const FCurve& Curve, const float Time)
+	{
+		const FKey* keys = Curve.Keys;
+		const int32 last = Curve.Num - 1;
+
+		if (Time <= keys[0].Time)
+			return keys[0].Value;
+		if (Time >= keys[last].Time)
+			return keys[last].Value;
+
+		int32 i = 1;
+		while (keys[i].Time < Time)
+			++i;
+
+		const FKey& a = keys[i - 1];
+		const FKey& b = keys[i];
+
+		return FMath::Lerp(a.Value, b.Value, (Time - a.Time) / (b.Time - a.Time));
+	}
+}
+
+UCF_CameraPoseComponent::UCF_CameraPoseComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+void UCF_CameraPoseComponent::Setup(UCameraComponent* inCamera, USpringArmComponent* inSpringLeaning, UCapsuleComponent* inCapsule, const float inHalfHeightStanding, const float inHalfHeightCrouch)
+{
+	Camera = inCamera;
+	SpringLeaning = inSpringLeaning;
+	Capsule = inCapsule;
+	HalfHeightStanding = inHalfHeightStanding;
+	HalfHeightCrouch = inHalfHeightCrouch;
+
+	if (Camera)
+		BaseRotation = Camera->GetRelativeRotation();
+}
+
+void UCF_CameraPoseComponent::SetPlayRate(const ECameraPoseChannel Channel, const float PlayRate)
+{
+	GetChannel(Channel).PlayRate = PlayRate;
+}
+
+void UCF_CameraPoseComponent::Play(const ECameraPoseChannel Channel)
+{
+	GetChannel(Channel).Direction = 1;
+	Wake();
+}
+
+void UCF_CameraPoseComponent::Reverse(const ECameraPoseChannel Channel)
+{
+	GetChannel(Channel).Direction = -1;
+	Wake();
+}
+
+void UCF_CameraPoseComponent::PlayFromStart(const ECameraPoseChannel Channel)
+{
+	GetChannel(Channel).Position = 0.f;
+	Play(Channel);
+}
+
+float UCF_CameraPoseComponent::GetPosition(const ECameraPoseChannel Channel) const
+{
+	return Channels[static_cast<int32>(Channel)].Position;
+}
+
+void UCF_CameraPoseComponent::SetLean(const float Start, const float Target, const float Distance)
+{
+	LeanStart = Start;
+	LeanTarget = Target;
+	LeanDistance = Distance;
+}
+
+void UCF_CameraPoseComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	VHS_SCOPE(CameraPoseTick);
+
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	bool bIsAnimating = false;
+	uint8 movedChannels = 0;
+
+	for (int32 i = 0; i < NumChannels; ++i)
+	{
+		FPoseChannel& channel = Channels[i];
+		if (channel.Direction == 0)
+			continue;
+
+		movedChannels |= 1 << i;
+
+		channel.Position = FMath::Clamp(channel.Position + channel.Direction * channel.PlayRate * DeltaTime, 0.f, 1.f);
+
+		if ((channel.Direction > 0 && channel.Position >= 1.f) || (channel.Direction < 0 && channel.Position <= 0.f))
+			channel.Direction = 0;
+		else
+			bIsAnimating = true;
+	}
+
+	ApplyPose(movedChannels);
+
+	if (!bIsAnimating)
+		SetComponentTickEnabled(false);
+}
+
+void UCF_CameraPoseComponent::Wake()
+{
+	if (!IsComponentTickEnabled())
+		SetComponentTickEnabled(true);
+}
+
+void UCF_CameraPoseComponent::ApplyPose(const uint8 MovedChannels)
+{
+	auto hasMoved = [MovedChannels](const ECameraPoseChannel Channel) { return (MovedChannels & (1 << static_cast<int32>(Channel))) != 0; };
+	const bool bCrouchMoved = hasMoved(ECameraPoseChannel::Crouch);
+	const bool bLeanMoved = hasMoved(ECameraPoseChannel::Lean);
+	const bool bZoomMoved = hasMoved(ECameraPoseChannel::Zoom);
+
+	const float crouch = GetPosition(ECameraPoseChannel::Crouch);
+	const float lean = FMath::Lerp(LeanStart, LeanTarget, CameraPoseCurves::Evaluate(CameraPoseCurves::Lean, GetPosition(ECameraPoseChannel::Lean)));
+	const float zoom = CameraPoseCurves::Evaluate(CameraPoseCurves::Zoom, GetPosition(ECameraPoseChannel::Zoom));
+	const float leanLength = lean * LeanDistance;
+
+	if (Capsule && bCrouchMoved)
+		Capsule->SetCapsuleHalfHeight(FMath::Lerp(HalfHeightStanding, HalfHeightCrouch, CameraPoseCurves::Evaluate(CameraPoseCurves::CrouchAlpha, crouch)));
+
+	if (SpringLeaning && bLeanMoved)
+	{
+		SpringLeaning->SocketOffset = FVector(0, leanLength, 0);
+		SpringLeaning->TargetArmLength = LeanArmLength - (lean * 10);
+	}
+
+	if (Camera && (bCrouchMoved || bLeanMoved))
+	{
+		FRotator rotation = BaseRotation;
+		rotation.Yaw += CameraPoseCurves::Evaluate(CameraPoseCurves::CrouchRotYaw, crouch);
+		rotation.Pitch += CameraPoseCurves::Evaluate(CameraPoseCurves::CrouchUpDown, crouch);
+		rotation.Roll += leanLength * .1f;
+
+		Camera->SetRelativeRotation(rotation);
+	}
+
+	if (!bZoomMoved)
+		return;
+
+	if (Camera)
+		Camera->SetFieldOfView(FMath::Lerp(DefaultFOV, ZoomFOV, zoom));
+
+	const int32 zoomLevel = FMath::RoundToInt(zoom * 2 + 2);
+	if (zoomLevel != ZoomLevel)
+	{
+		ZoomLevel = zoomLevel;
+		OnZoomLevelChanged.Broadcast(ZoomLevel);
+	}
+}
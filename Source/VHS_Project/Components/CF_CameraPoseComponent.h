@@ -0,0 +1,101 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+
+#include "CF_CameraPoseComponent.generated.h"
+
+// # Engine Forwards
+class UCameraComponent;
+class USpringArmComponent;
+class UCapsuleComponent;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnZoomLevelChanged, int32)
+
+enum class ECameraPoseChannel : uint8
+{
+	Crouch,
+	Lean,
+	Zoom,
+	MAX
+};
+
+/**
+ * Drives the procedural crouch, lean and zoom animation of the first person camera. Every channel is evaluated
+ * from a compile-time curve table in a single pass, the combined pose is written once per frame and the component
+ * stops ticking while no channel is moving.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class VHS_PROJECT_API UCF_CameraPoseComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UCF_CameraPoseComponent();
+
+	/** Fired when the zoom readout (2 to 4) changes */
+	FOnZoomLevelChanged OnZoomLevelChanged;
+
+	void Setup(UCameraComponent* inCamera, USpringArmComponent* inSpringLeaning, UCapsuleComponent* inCapsule, const float inHalfHeightStanding, const float inHalfHeightCrouch);
+
+	void SetPlayRate(const ECameraPoseChannel Channel, const float PlayRate);
+
+	void Play(const ECameraPoseChannel Channel);
+
+	void Reverse(const ECameraPoseChannel Channel);
+
+	void PlayFromStart(const ECameraPoseChannel Channel);
+
+	float GetPosition(const ECameraPoseChannel Channel) const;
+
+	/** Lean blends from Start to Target (-1 left, 1 right) over the lean channel */
+	void SetLean(const float Start, const float Target, const float Distance);
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Camera")
+	float DefaultFOV = 65.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Camera")
+	float ZoomFOV = 30.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Camera")
+	float LeanArmLength = 30.f;
+
+	struct FPoseChannel
+	{
+		float Position = 0.f;
+		float PlayRate = 1.f;
+		int8 Direction = 0;
+	};
+
+	static constexpr int32 NumChannels = static_cast<int32>(ECameraPoseChannel::MAX);
+
+	FPoseChannel Channels[NumChannels];
+
+	UPROPERTY() UCameraComponent* Camera = nullptr;
+	UPROPERTY() USpringArmComponent* SpringLeaning = nullptr;
+	UPROPERTY() UCapsuleComponent* Capsule = nullptr;
+
+	float HalfHeightStanding = 90.f;
+	float HalfHeightCrouch = 20.f;
+
+	float LeanStart = 0.f;
+	float LeanTarget = 0.f;
+	float LeanDistance = 50.f;
+
+	FRotator BaseRotation = FRotator::ZeroRotator;
+	int32 ZoomLevel = INDEX_NONE;
+
+	// -------------------------------------------------------------------------
+
+	FPoseChannel& GetChannel(const ECameraPoseChannel Channel) { return Channels[static_cast<int32>(Channel)]; }
+
+	void Wake();
+
+	/** Writes the combined pose, MovedChannels is a bit mask of the channels that advanced this frame */
+	void ApplyPose(const uint8 MovedChannels);
+};
@@ -0,0 +1,107 @@
+#include "CF_GhostPerceptionComponent.h"
+
+// # Engine Includes
+#include "Engine/World.h"
+
+// # Project Includes
+#include "VHS_Project.h"
+#include "Subsystems/CF_PerceptionSubsystem.h"
+#include "Subsystems/CF_SignificanceSubsystem.h"
+#include "Subsystems/CF_TriggerSubsystem.h"
+
+UCF_GhostPerceptionComponent::UCF_GhostPerceptionComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UCF_GhostPerceptionComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (auto* perception = GetWorld()->GetSubsystem<UCF_PerceptionSubsystem>())
+		perception->Register(this);
+
+	if (auto* significance = GetWorld()->GetSubsystem<UCF_SignificanceSubsystem>())
+		significance->Register(this);
+
+	if (auto* triggers = GetWorld()->GetSubsystem<UCF_TriggerSubsystem>())
+		triggers->RegisterActor(GetOwner(), ETriggerActor::Ghost, GetOwner()->GetSimpleCollisionRadius());
+}
+
+void UCF_GhostPerceptionComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (auto* perception = GetWorld()->GetSubsystem<UCF_PerceptionSubsystem>())
+		perception->Unregister(this);
+
+	if (auto* significance = GetWorld()->GetSubsystem<UCF_SignificanceSubsystem>())
+		significance->Unregister(this);
+
+	if (auto* triggers = GetWorld()->GetSubsystem<UCF_TriggerSubsystem>())
+		triggers->UnregisterActor(GetOwner());
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UCF_GhostPerceptionComponent::SetPerceptionEnabled(const bool bEnabled)
+{
+	if (auto* perception = GetWorld()->GetSubsystem<UCF_PerceptionSubsystem>())
+		perception->SetActive(this, bEnabled);
+}
+
+void UCF_GhostPerceptionComponent::ResetAwareness()
+{
+	Awareness = 0.f;
+	SetGhostState(EGhostState::Idle);
+}
+
+float UCF_GhostPerceptionComponent::GetSightFactor(const FVector& Location, const float Radius, const float RangeScale) const
+{
+	const FVector toTarget = Location - GetComponentLocation();
+	const float distance = toTarget.Size();
+
+	const float sightRange = SightRange * RangeScale;
+	const float peripheralRange = PeripheralRange * RangeScale;
+	if (distance - Radius > FMath::Max(sightRange, peripheralRange))
+		return 0.f;
+
+	// Inside the sphere every direction sees it
+	if (distance <= Radius)
+		return 1.f;
+
+	// The sphere is in the cone when its closest edge is, angle to the center minus the angular radius
+	const float cosAngle = FVector::DotProduct(GetForwardVector(), toTarget / distance);
+	const float angle = FMath::RadiansToDegrees(FMath::Acos(FMath::Clamp(cosAngle, -1.f, 1.f)) - FMath::Asin(Radius / distance));
+
+	float factor = 0.f;
+	if (angle <= SightHalfAngle && distance - Radius <= sightRange)
+		factor = 1.f - .5f * FMath::Clamp(distance / sightRange, 0.f, 1.f);
+	else if (angle <= PeripheralHalfAngle && distance - Radius <= peripheralRange)
+		factor = PeripheralGain * (1.f - .5f * FMath::Clamp(distance / peripheralRange, 0.f, 1.f));
+
+	return factor;
+}
+
+void UCF_GhostPerceptionComponent::Integrate(const float Stimulus, const float DeltaTime)
+{
+	Awareness = Stimulus > 0.f
+		? FMath::Min(Awareness + Stimulus * GainRate * DeltaTime, 1.f)
+		: FMath::Max(Awareness - DecayRate * DeltaTime, 0.f);
+
+	// Once alerted the ghost only calms down when awareness is gone, suspicion follows awareness both ways
+	if (Awareness >= 1.f)
+		SetGhostState(EGhostState::Alerted);
+	else if (Awareness <= 0.f)
+		SetGhostState(EGhostState::Idle);
+	else if (GhostState != EGhostState::Alerted)
+		SetGhostState(Awareness >= SuspiciousThreshold ? EGhostState::Suspicious : EGhostState::Idle);
+}
+
+void UCF_GhostPerceptionComponent::SetGhostState(const EGhostState NewState)
+{
+	if (GhostState == NewState)
+		return;
+
+	const EGhostState oldState = GhostState;
+	GhostState = NewState;
+	OnGhostStateChanged.Broadcast(NewState, oldState);
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SceneComponent.h"
+
+#include "CF_GhostPerceptionComponent.generated.h"
+
+UENUM(BlueprintType)
+enum class EGhostState : uint8
+{
+	Idle,
+	Suspicious,
+	Alerted
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnGhostStateChanged, EGhostState, NewState, EGhostState, OldState);
+
+/**
+ * Sight of a ghost, attach it to the eyes. Cone membership is tested analytically against the player's head and
+ * body, line of sight is an async trace batched with every other ghost by UCF_PerceptionSubsystem, which also
+ * decides when this ghost is due. Awareness builds while the player is seen and decays otherwise.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class VHS_PROJECT_API UCF_GhostPerceptionComponent : public USceneComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UCF_GhostPerceptionComponent();
+
+	UPROPERTY(BlueprintAssignable, Category = "Perception")
+	FOnGhostStateChanged OnGhostStateChanged;
+
+	UFUNCTION(BlueprintPure, Category = "Perception")
+	EGhostState GetGhostState() const { return GhostState; }
+
+	/** 0 unaware to 1 alerted */
+	UFUNCTION(BlueprintPure, Category = "Perception")
+	float GetAwareness() const { return Awareness; }
+
+	/** Disabled ghosts issue no queries and keep their awareness */
+	UFUNCTION(BlueprintCallable, Category = "Perception")
+	void SetPerceptionEnabled(const bool bEnabled);
+
+	UFUNCTION(BlueprintCallable, Category = "Perception")
+	void ResetAwareness();
+
+	float GetUpdateInterval() const { return UpdateRate * RateScale > 0.f ? 1.f / (UpdateRate * RateScale) : 0.f; }
+
+	/** Set by UCF_SignificanceSubsystem, distant or hidden ghosts look less often */
+	void SetRateScale(const float Scale) { RateScale = Scale; }
+
+	ECollisionChannel GetTraceChannel() const { return TraceChannel; }
+
+	/**
+	 * How strongly a sphere at Location is seen ignoring occlusion, 0 outside both cones.
+	 * RangeScale stretches both ranges for the target's pose and light.
+	 */
+	float GetSightFactor(const FVector& Location, const float Radius, const float RangeScale) const;
+
+	/** Advances awareness by DeltaTime with the strongest visible stimulus, 0 when nothing was seen */
+	void Integrate(const float Stimulus, const float DeltaTime);
+
+protected:
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Replaces SM_Cone_60deg */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Perception")
+	float SightRange = 2000.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Perception")
+	float SightHalfAngle = 30.f;
+
+	/** Replaces SM_Cone_90deg */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Perception")
+	float PeripheralRange = 800.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Perception")
+	float PeripheralHalfAngle = 45.f;
+
+	/** Awareness gained from the peripheral cone relative to the sight cone */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Perception")
+	float PeripheralGain = .4f;
+
+	/** Sight checks per second, far or idle ghosts can run lower */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Perception")
+	float UpdateRate = 10.f;
+
+	/** Awareness per second while the player is fully seen at point blank */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Perception")
+	float GainRate = 1.5f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Perception")
+	float DecayRate = .15f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Perception")
+	float SuspiciousThreshold = .3f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Perception")
+	TEnumAsByte<ECollisionChannel> TraceChannel = ECC_Visibility;
+
+	EGhostState GhostState = EGhostState::Idle;
+	float Awareness = 0.f;
+	float RateScale = 1.f;
+
+	// -------------------------------------------------------------------------
+
+	void SetGhostState(const EGhostState NewState);
+};
@@ -0,0 +1,119 @@
+#include "CF_HeadbobComponent.h"
+
+// # Engine Includes
+#include "Camera/CameraShakeBase.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+
+// # Project Includes
+#include "VHS_Project.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Headbob Live Shakes"), STAT_VHS_HeadbobShakes, STATGROUP_VHS);
+DECLARE_CYCLE_STAT(TEXT("Headbob Tick"), STAT_VHS_HeadbobTick, STATGROUP_VHS);
+
+UCF_HeadbobComponent::UCF_HeadbobComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = true;
+}
+
+void UCF_HeadbobComponent::Setup(const TSubclassOf<UCameraShakeBase>& inIdle, const TSubclassOf<UCameraShakeBase>& inWalk, const TSubclassOf<UCameraShakeBase>& inRun)
+{
+	StopAll();
+
+	Shakes[static_cast<int32>(EHeadbobBand::Idle)] = inIdle;
+	Shakes[static_cast<int32>(EHeadbobBand::Walk)] = inWalk;
+	Shakes[static_cast<int32>(EHeadbobBand::Run)] = inRun;
+}
+
+void UCF_HeadbobComponent::SetBand(const EHeadbobBand Band)
+{
+	ActiveBand = Band;
+}
+
+int32 UCF_HeadbobComponent::GetLiveShakeCount() const
+{
+	int32 count = 0;
+	for (const auto* instance : Instances)
+	{
+		if (instance && !instance->IsFinished())
+			++count;
+	}
+
+	return count;
+}
+
+void UCF_HeadbobComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	VHS_SCOPE(HeadbobTick);
+
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	APlayerCameraManager* cameraManager = GetCameraManager();
+	if (!cameraManager)
+		return;
+
+	const float fadeSpeed = CrossfadeTime > 0.f ? 1.f / CrossfadeTime : 0.f;
+
+	for (int32 i = 0; i < NumBands; ++i)
+	{
+		const float target = i == static_cast<int32>(ActiveBand) ? 1.f : 0.f;
+		Weights[i] = fadeSpeed > 0.f ? FMath::FInterpConstantTo(Weights[i], target, DeltaTime, fadeSpeed) : target;
+
+		UCameraShakeBase*& instance = Instances[i];
+
+		if (Weights[i] <= 0.f)
+		{
+			if (instance)
+			{
+				cameraManager->StopCameraShake(instance, true);
+				instance = nullptr;
+			}
+			continue;
+		}
+
+		// Shakes with a finite duration are restarted once, not stacked
+		if (!instance || instance->IsFinished())
+		{
+			if (!Shakes[i])
+				continue;
+
+			instance = cameraManager->StartCameraShake(Shakes[i], Weights[i], ECameraShakePlaySpace::CameraLocal);
+		}
+
+		if (instance)
+			instance->ShakeScale = Weights[i];
+	}
+
+	SET_DWORD_STAT(STAT_VHS_HeadbobShakes, GetLiveShakeCount());
+}
+
+void UCF_HeadbobComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	StopAll();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+APlayerCameraManager* UCF_HeadbobComponent::GetCameraManager() const
+{
+	const auto* pawn = Cast<APawn>(GetOwner());
+	const auto* pc = pawn ? pawn->GetController<APlayerController>() : nullptr;
+
+	return pc ? pc->PlayerCameraManager : nullptr;
+}
+
+void UCF_HeadbobComponent::StopAll()
+{
+	APlayerCameraManager* cameraManager = GetCameraManager();
+
+	for (int32 i = 0; i < NumBands; ++i)
+	{
+		if (Instances[i] && cameraManager)
+			cameraManager->StopCameraShake(Instances[i], true);
+
+		Instances[i] = nullptr;
+		Weights[i] = 0.f;
+	}
+}
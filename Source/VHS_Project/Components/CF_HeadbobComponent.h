@@ -0,0 +1,64 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+
+#include "CF_HeadbobComponent.generated.h"
+
+// # Engine Forwards
+class UCameraShakeBase;
+class APlayerCameraManager;
+
+enum class EHeadbobBand : uint8
+{
+	Idle,
+	Walk,
+	Run,
+	MAX
+};
+
+/**
+ * Keeps at most one camera shake per movement band alive and crossfades their scale when the band changes,
+ * instead of starting a new shake every frame.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class VHS_PROJECT_API UCF_HeadbobComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UCF_HeadbobComponent();
+
+	void Setup(const TSubclassOf<UCameraShakeBase>& inIdle, const TSubclassOf<UCameraShakeBase>& inWalk, const TSubclassOf<UCameraShakeBase>& inRun);
+
+	void SetBand(const EHeadbobBand Band);
+
+	int32 GetLiveShakeCount() const;
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Seconds it takes to fade a band fully in or out */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | CameraShakes")
+	float CrossfadeTime = 0.35f;
+
+	static constexpr int32 NumBands = static_cast<int32>(EHeadbobBand::MAX);
+
+	TSubclassOf<UCameraShakeBase> Shakes[NumBands];
+
+	UPROPERTY(Transient) UCameraShakeBase* Instances[NumBands] = {};
+
+	float Weights[NumBands] = {};
+
+	EHeadbobBand ActiveBand = EHeadbobBand::Idle;
+
+	// -------------------------------------------------------------------------
+
+	APlayerCameraManager* GetCameraManager() const;
+
+	void StopAll();
+};
@@ -0,0 +1,126 @@
+#include "CF_StaminaComponent.h"
+
+// # Engine Includes
+#include "Engine/World.h"
+#include "TimerManager.h"
+
+// # Project Includes
+#include "VHS_Project.h"
+
+DECLARE_CYCLE_STAT(TEXT("Stamina Threshold"), STAT_VHS_StaminaThreshold, STATGROUP_VHS);
+
+UCF_StaminaComponent::UCF_StaminaComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UCF_StaminaComponent::Setup(const float inMaxStamina, const float inMaxSprintTime, const float inTimeToRegenStamina, const float inDelayStaminaRegen)
+{
+	MaxStamina = inMaxStamina;
+	MaxSprintTime = inMaxSprintTime;
+	TimeToRegenStamina = inTimeToRegenStamina;
+	DelayStaminaRegen = inDelayStaminaRegen;
+
+	EnterState(EStaminaState::Idle, MaxStamina);
+}
+
+void UCF_StaminaComponent::StartConsumption()
+{
+	const float stamina = GetStamina();
+	EnterState(EStaminaState::Consuming, stamina);
+
+	ScheduleThreshold(stamina / GetConsumeRate());
+}
+
+void UCF_StaminaComponent::StartRegen()
+{
+	const float stamina = GetStamina();
+	if (stamina >= MaxStamina)
+	{
+		EnterState(EStaminaState::Idle, MaxStamina);
+		return;
+	}
+
+	if (DelayStaminaRegen > 0.f)
+	{
+		EnterState(EStaminaState::RegenDelay, stamina);
+		ScheduleThreshold(DelayStaminaRegen);
+		return;
+	}
+
+	EnterState(EStaminaState::Regenerating, stamina);
+	ScheduleThreshold((MaxStamina - stamina) / GetRegenRate());
+}
+
+float UCF_StaminaComponent::GetStamina() const
+{
+	const float elapsed = static_cast<float>(GetTime() - StartTime);
+
+	switch (State)
+	{
+	case EStaminaState::Consuming:		return FMath::Max(StartStamina - GetConsumeRate() * elapsed, 0.f);
+	case EStaminaState::Regenerating:	return FMath::Min(StartStamina + GetRegenRate() * elapsed, MaxStamina);
+	default:							return StartStamina;
+	}
+}
+
+void UCF_StaminaComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (auto* world = GetWorld())
+		world->GetTimerManager().ClearTimer(TH_Threshold);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+double UCF_StaminaComponent::GetTime() const
+{
+	const UWorld* world = GetWorld();
+	return world ? world->GetTimeSeconds() : 0.0;
+}
+
+void UCF_StaminaComponent::EnterState(const EStaminaState NewState, const float Stamina)
+{
+	State = NewState;
+	StartStamina = Stamina;
+	StartTime = GetTime();
+
+	if (auto* world = GetWorld())
+		world->GetTimerManager().ClearTimer(TH_Threshold);
+}
+
+void UCF_StaminaComponent::ScheduleThreshold(const float Delay)
+{
+	if (Delay <= 0.f)
+	{
+		HandleThreshold();
+		return;
+	}
+
+	if (auto* world = GetWorld())
+		world->GetTimerManager().SetTimer(TH_Threshold, this, &UCF_StaminaComponent::HandleThreshold, Delay, false);
+}
+
+void UCF_StaminaComponent::HandleThreshold()
+{
+	VHS_SCOPE(StaminaThreshold);
+
+	switch (State)
+	{
+	case EStaminaState::Consuming:
+		EnterState(EStaminaState::Idle, 0.f);
+		OnStaminaDepleted.Broadcast();
+		break;
+
+	case EStaminaState::RegenDelay:
+		EnterState(EStaminaState::Regenerating, StartStamina);
+		ScheduleThreshold((MaxStamina - StartStamina) / GetRegenRate());
+		break;
+
+	case EStaminaState::Regenerating:
+		EnterState(EStaminaState::Idle, MaxStamina);
+		break;
+
+	default:
+		break;
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+
+#include "CF_StaminaComponent.generated.h"
+
+DECLARE_MULTICAST_DELEGATE(FOnStaminaDepleted)
+
+enum class EStaminaState : uint8
+{
+	Idle,
+	Consuming,
+	RegenDelay,
+	Regenerating
+};
+
+/**
+ * Stamina is never stepped. The component stores where the current phase started and its rate,
+ * evaluates the value in closed form on demand and only keeps one timer for the next threshold:
+ * depletion, end of the regen delay or full regen.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class VHS_PROJECT_API UCF_StaminaComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UCF_StaminaComponent();
+
+	FOnStaminaDepleted OnStaminaDepleted;
+
+	void Setup(const float inMaxStamina, const float inMaxSprintTime, const float inTimeToRegenStamina, const float inDelayStaminaRegen);
+
+	void StartConsumption();
+
+	void StartRegen();
+
+	UFUNCTION(BlueprintPure, Category = "Stamina")
+	float GetStamina() const;
+
+	UFUNCTION(BlueprintPure, Category = "Stamina")
+	float GetStaminaRatio() const { return MaxStamina > 0.f ? GetStamina() / MaxStamina : 0.f; }
+
+protected:
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	float MaxStamina = 100.f;
+	float MaxSprintTime = 7.f;
+	float TimeToRegenStamina = 5.f;
+	float DelayStaminaRegen = 2.f;
+
+	EStaminaState State = EStaminaState::Idle;
+	float StartStamina = 100.f;
+	double StartTime = 0.0;
+
+	FTimerHandle TH_Threshold;
+
+	// -------------------------------------------------------------------------
+
+	float GetConsumeRate() const { return MaxSprintTime > 0.f ? MaxStamina / MaxSprintTime : UE_BIG_NUMBER; }
+
+	float GetRegenRate() const { return TimeToRegenStamina > 0.f ? MaxStamina / TimeToRegenStamina : UE_BIG_NUMBER; }
+
+	double GetTime() const;
+
+	void EnterState(const EStaminaState NewState, const float Stamina);
+
+	void ScheduleThreshold(const float Delay);
+
+	void HandleThreshold();
+};
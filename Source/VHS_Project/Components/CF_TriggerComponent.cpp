@@ -0,0 +1,41 @@
+#include "CF_TriggerComponent.h"
+
+// # Engine Includes
+#include "Engine/World.h"
+
+// # Project Includes
+#include "VHS_Project.h"
+#include "Subsystems/CF_TriggerSubsystem.h"
+
+UCF_TriggerComponent::UCF_TriggerComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	// Shape only, no body in the physics scene and no overlap events
+	SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+	SetGenerateOverlapEvents(false);
+	SetCanEverAffectNavigation(false);
+	bHiddenInGame = true;
+}
+
+void UCF_TriggerComponent::DisableTrigger()
+{
+	if (auto* triggers = GetWorld()->GetSubsystem<UCF_TriggerSubsystem>())
+		triggers->UnregisterTrigger(this);
+}
+
+void UCF_TriggerComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (auto* triggers = GetWorld()->GetSubsystem<UCF_TriggerSubsystem>())
+		triggers->RegisterTrigger(this);
+}
+
+void UCF_TriggerComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (auto* triggers = GetWorld()->GetSubsystem<UCF_TriggerSubsystem>())
+		triggers->UnregisterTrigger(this);
+
+	Super::EndPlay(EndPlayReason);
+}
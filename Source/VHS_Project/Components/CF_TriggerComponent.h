@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/BoxComponent.h"
+
+#include "CF_TriggerComponent.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnTriggerActor, UCF_TriggerComponent*, Trigger, AActor*, Actor);
+
+/**
+ * Box trigger without a physics body, meant for BP_PlayerTrigger, BP_GhostTrigger and their single use variants.
+ * Their overlap box has to be swapped for it in the editor, until then it stays in the physics scene.
+ * UCF_TriggerSubsystem tests the player and the ghosts against it through a spatial hash. The box is static once
+ * play begins.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class VHS_PROJECT_API UCF_TriggerComponent : public UBoxComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UCF_TriggerComponent();
+
+	UPROPERTY(BlueprintAssignable, Category = "Trigger")
+	FOnTriggerActor OnActorEnter;
+
+	/** Never fired by single use triggers */
+	UPROPERTY(BlueprintAssignable, Category = "Trigger")
+	FOnTriggerActor OnActorExit;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "CustomProperties | Trigger")
+	bool bTriggeredByPlayer = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "CustomProperties | Trigger")
+	bool bTriggeredByGhosts = false;
+
+	/** Leaves the trigger system for good after the first enter */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "CustomProperties | Trigger")
+	bool bSingleUse = false;
+
+	/** Removes the trigger without firing it, e.g. when the sequence it starts was skipped */
+	UFUNCTION(BlueprintCallable, Category = "Trigger")
+	void DisableTrigger();
+
+protected:
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+};
@@ -0,0 +1,240 @@
+#include "CF_VHSEffectsComponent.h"
+
+// # Engine Includes
+#include "Camera/CameraComponent.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Materials/MaterialParameterCollection.h"
+#include "Materials/MaterialParameterCollectionInstance.h"
+#include "TimerManager.h"
+
+// # Project Includes
+#include "VHS_Project.h"
+#include "Subsystems/CF_PerceptionSubsystem.h"
+#include "Subsystems/CF_QualityScalerSubsystem.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("VHS Parameter Writes"), STAT_VHS_EffectWrites, STATGROUP_VHS);
+DECLARE_CYCLE_STAT(TEXT("VHS Effects Flush"), STAT_VHS_EffectsFlush, STATGROUP_VHS);
+
+UCF_VHSEffectsComponent::UCF_VHSEffectsComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+
+	for (auto& vector : Vectors)
+		vector = FLinearColor::Black;
+}
+
+void UCF_VHSEffectsComponent::Setup(UCameraComponent* inCamera, const TArray<UMaterialInterface*>& PostprocessMaterials)
+{
+	Camera = inCamera;
+
+	for (auto* instance : PostprocessInstances)
+		UnbindMaterial(instance);
+
+	PostprocessInstances.Reset();
+
+	if (Camera)
+	{
+		TArray<FWeightedBlendable> blendables;
+		for (auto* material : PostprocessMaterials)
+		{
+			if (!material)
+				continue;
+
+			auto* instance = UMaterialInstanceDynamic::Create(material, this);
+			PostprocessInstances.Add(instance);
+			blendables.Add(FWeightedBlendable(1.f, instance));
+		}
+
+		Camera->PostProcessSettings.WeightedBlendables.Array = blendables;
+	}
+
+	// MPC_Global is referenced by the VHS materials, it's resident by the time the player begins play
+	Collection = GlobalParameters.LoadSynchronous();
+	for (int32 i = 0; i < NumScalars; ++i)
+		bCollectionHasScalar[i] = Collection && Collection->GetScalarParameterByName(GetParamName(static_cast<EVHSScalar>(i)));
+	for (int32 i = 0; i < NumVectors; ++i)
+		bCollectionHasVector[i] = Collection && Collection->GetVectorParameterByName(GetParamName(static_cast<EVHSVector>(i)));
+
+	for (auto* instance : PostprocessInstances)
+		BindMaterial(instance);
+
+	if (auto* scaler = GetWorld()->GetSubsystem<UCF_QualityScalerSubsystem>())
+	{
+		scaler->OnQualityTierChanged.AddUniqueDynamic(this, &UCF_VHSEffectsComponent::HandleQualityTierChanged);
+		SetScalar(EVHSScalar::QualityTier, scaler->GetTier());
+	}
+
+	if (TapeStateRate > 0.f)
+		GetWorld()->GetTimerManager().SetTimer(TH_TapeState, this, &UCF_VHSEffectsComponent::UpdateTapeState, 1.f / TapeStateRate, true);
+
+	UpdateTapeState();
+
+	// Everything is written once so every target starts from the same state
+	DirtyScalars = (1u << NumScalars) - 1;
+	DirtyVectors = (1u << NumVectors) - 1;
+	Wake();
+}
+
+void UCF_VHSEffectsComponent::BindMaterial(UMaterialInstanceDynamic* Material)
+{
+	if (!Material || BoundMaterials.ContainsByPredicate([Material](const FBoundMaterial& bound) { return bound.Material == Material; }))
+		return;
+
+	FBoundMaterial& bound = BoundMaterials.AddDefaulted_GetRef();
+	bound.Material = Material;
+
+	// Parameters the material doesn't expose resolve to INDEX_NONE and are skipped on flush
+	for (int32 i = 0; i < NumScalars; ++i)
+	{
+		bound.ScalarIndices[i] = INDEX_NONE;
+		Material->InitializeScalarParameterAndGetIndex(GetParamName(static_cast<EVHSScalar>(i)), Scalars[i], bound.ScalarIndices[i]);
+	}
+
+	for (int32 i = 0; i < NumVectors; ++i)
+	{
+		bound.VectorIndices[i] = INDEX_NONE;
+		Material->InitializeVectorParameterAndGetIndex(GetParamName(static_cast<EVHSVector>(i)), Vectors[i], bound.VectorIndices[i]);
+	}
+}
+
+void UCF_VHSEffectsComponent::UnbindMaterial(UMaterialInstanceDynamic* Material)
+{
+	BoundMaterials.RemoveAll([Material](const FBoundMaterial& bound) { return bound.Material == Material; });
+}
+
+void UCF_VHSEffectsComponent::SetScalar(const EVHSScalar Param, const float Value)
+{
+	const int32 idx = static_cast<int32>(Param);
+	if (Scalars[idx] == Value)
+		return;
+
+	Scalars[idx] = Value;
+	DirtyScalars |= 1u << idx;
+	Wake();
+}
+
+void UCF_VHSEffectsComponent::SetVector(const EVHSVector Param, const FLinearColor& Value)
+{
+	const int32 idx = static_cast<int32>(Param);
+	if (Vectors[idx] == Value)
+		return;
+
+	Vectors[idx] = Value;
+	DirtyVectors |= 1u << idx;
+	Wake();
+}
+
+void UCF_VHSEffectsComponent::SetMissingBattery(const float MissingBattery)
+{
+	const float twoThirds = 1.f / 1.5f;
+
+	SetScalar(EVHSScalar::MissingBattery, FMath::Min(MissingBattery, twoThirds));
+	SetScalar(EVHSScalar::BatteryLow, MissingBattery < twoThirds ? 0.f : 1.f);
+}
+
+void UCF_VHSEffectsComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	Flush();
+	SetComponentTickEnabled(false);
+}
+
+void UCF_VHSEffectsComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	GetWorld()->GetTimerManager().ClearTimer(TH_TapeState);
+
+	if (auto* scaler = GetWorld()->GetSubsystem<UCF_QualityScalerSubsystem>())
+		scaler->OnQualityTierChanged.RemoveDynamic(this, &UCF_VHSEffectsComponent::HandleQualityTierChanged);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+FName UCF_VHSEffectsComponent::GetParamName(const EVHSScalar Param)
+{
+	static const FName Names[NumScalars] = { FName("MissingBattery"), FName("BatteryLow"), FName("TapeWear"), FName("Distortion"), FName("QualityTier") };
+	return Names[static_cast<int32>(Param)];
+}
+
+FName UCF_VHSEffectsComponent::GetParamName(const EVHSVector Param)
+{
+	static const FName Names[NumVectors] = { FName("TapeTint") };
+	return Names[static_cast<int32>(Param)];
+}
+
+void UCF_VHSEffectsComponent::Wake()
+{
+	if (!IsComponentTickEnabled())
+		SetComponentTickEnabled(true);
+}
+
+void UCF_VHSEffectsComponent::UpdateTapeState()
+{
+	auto* world = GetWorld();
+	if (!world)
+		return;
+
+	if (TapeWearTime > 0.f)
+		SetTapeWear(FMath::Min(world->GetRealTimeSeconds() / (TapeWearTime * 60.f), 1.f));
+
+	if (auto* perception = world->GetSubsystem<UCF_PerceptionSubsystem>())
+		SetDistortion(perception->GetMaxAwareness() * MaxDistortion);
+}
+
+void UCF_VHSEffectsComponent::HandleQualityTierChanged(int32 Tier)
+{
+	SetScalar(EVHSScalar::QualityTier, static_cast<float>(Tier));
+}
+
+void UCF_VHSEffectsComponent::Flush()
+{
+	VHS_SCOPE(EffectsFlush);
+
+	if (!DirtyScalars && !DirtyVectors)
+		return;
+
+	uint32 writes = 0;
+
+	BoundMaterials.RemoveAll([](const FBoundMaterial& bound) { return !bound.Material.IsValid(); });
+
+	for (const FBoundMaterial& bound : BoundMaterials)
+	{
+		UMaterialInstanceDynamic* material = bound.Material.Get();
+
+		for (int32 i = 0; i < NumScalars; ++i)
+		{
+			if ((DirtyScalars & (1u << i)) && bound.ScalarIndices[i] != INDEX_NONE && material->SetScalarParameterByIndex(bound.ScalarIndices[i], Scalars[i]))
+				++writes;
+		}
+
+		for (int32 i = 0; i < NumVectors; ++i)
+		{
+			if ((DirtyVectors & (1u << i)) && bound.VectorIndices[i] != INDEX_NONE && material->SetVectorParameterByIndex(bound.VectorIndices[i], Vectors[i]))
+				++writes;
+		}
+	}
+
+	// Collection instances have no index API so these go by name, the instance defers its uniform buffer update to
+	// the end of the frame and all of them land in one update
+	UMaterialParameterCollectionInstance* collection = Collection ? GetWorld()->GetParameterCollectionInstance(Collection) : nullptr;
+	if (collection)
+	{
+		for (int32 i = 0; i < NumScalars; ++i)
+		{
+			if ((DirtyScalars & (1u << i)) && bCollectionHasScalar[i] && collection->SetScalarParameterValue(GetParamName(static_cast<EVHSScalar>(i)), Scalars[i]))
+				++writes;
+		}
+
+		for (int32 i = 0; i < NumVectors; ++i)
+		{
+			if ((DirtyVectors & (1u << i)) && bCollectionHasVector[i] && collection->SetVectorParameterValue(GetParamName(static_cast<EVHSVector>(i)), Vectors[i]))
+				++writes;
+		}
+	}
+
+	DirtyScalars = 0;
+	DirtyVectors = 0;
+
+	INC_DWORD_STAT_BY(STAT_VHS_EffectWrites, writes);
+}
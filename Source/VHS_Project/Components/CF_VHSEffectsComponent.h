@@ -0,0 +1,130 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+
+#include "CF_VHSEffectsComponent.generated.h"
+
+// # Engine Forwards
+class UCameraComponent;
+class UMaterialInterface;
+class UMaterialInstanceDynamic;
+class UMaterialParameterCollection;
+
+enum class EVHSScalar : uint8
+{
+	MissingBattery,
+	BatteryLow,
+	TapeWear,
+	Distortion,
+	QualityTier,
+	MAX
+};
+
+enum class EVHSVector : uint8
+{
+	TapeTint,
+	MAX
+};
+
+/**
+ * Single owner of the VHS look: the camera post-process stack, MPC_Global and any material that wants the
+ * same parameters (the HUD battery). Parameter indices are resolved once when a material is bound, values are
+ * collected during the frame and every changed one is written in a single game thread flush. Each instance write
+ * still enqueues its own render command, MPC_Global writes coalesce into one uniform buffer update.
+ * Tape wear follows the recording time and distortion the awareness of the closest ghost to spotting the player.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class VHS_PROJECT_API UCF_VHSEffectsComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UCF_VHSEffectsComponent();
+
+	/** Builds a dynamic instance of each post-process material and adds them to the camera blendables */
+	void Setup(UCameraComponent* inCamera, const TArray<UMaterialInterface*>& PostprocessMaterials);
+
+	/** Material gets every VHS parameter it exposes from now on */
+	void BindMaterial(UMaterialInstanceDynamic* Material);
+
+	void UnbindMaterial(UMaterialInstanceDynamic* Material);
+
+	void SetScalar(const EVHSScalar Param, const float Value);
+
+	void SetVector(const EVHSVector Param, const FLinearColor& Value);
+
+	/** 0 is a full battery, the battery reads low from two thirds on */
+	UFUNCTION(BlueprintCallable, Category = "VHS")
+	void SetMissingBattery(const float MissingBattery);
+
+	UFUNCTION(BlueprintCallable, Category = "VHS")
+	void SetTapeWear(const float TapeWear) { SetScalar(EVHSScalar::TapeWear, TapeWear); }
+
+	UFUNCTION(BlueprintCallable, Category = "VHS")
+	void SetDistortion(const float Distortion) { SetScalar(EVHSScalar::Distortion, Distortion); }
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Minutes of recording until the tape is fully worn */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | VHS")
+	float TapeWearTime = 30.f;
+
+	/** Distortion at full ghost awareness */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | VHS")
+	float MaxDistortion = 1.f;
+
+	/** Tape wear and distortion are sampled at this rate, awareness doesn't change faster than the sight checks */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | VHS")
+	float TapeStateRate = 10.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | VHS")
+	TSoftObjectPtr<UMaterialParameterCollection> GlobalParameters = TSoftObjectPtr<UMaterialParameterCollection>(FSoftObjectPath(TEXT("/Game/00_Main/MATERIALS/MPC_Global.MPC_Global")));
+
+	static constexpr int32 NumScalars = static_cast<int32>(EVHSScalar::MAX);
+	static constexpr int32 NumVectors = static_cast<int32>(EVHSVector::MAX);
+
+	struct FBoundMaterial
+	{
+		TWeakObjectPtr<UMaterialInstanceDynamic> Material;
+		int32 ScalarIndices[NumScalars];
+		int32 VectorIndices[NumVectors];
+	};
+
+	UPROPERTY() UCameraComponent* Camera = nullptr;
+	UPROPERTY() TArray<UMaterialInstanceDynamic*> PostprocessInstances;
+	UPROPERTY() UMaterialParameterCollection* Collection = nullptr;
+
+	TArray<FBoundMaterial> BoundMaterials;
+
+	bool bCollectionHasScalar[NumScalars] = {};
+	bool bCollectionHasVector[NumVectors] = {};
+
+	float Scalars[NumScalars] = {};
+	FLinearColor Vectors[NumVectors];
+
+	uint32 DirtyScalars = 0;
+	uint32 DirtyVectors = 0;
+
+	FTimerHandle TH_TapeState;
+
+	// -------------------------------------------------------------------------
+
+	static FName GetParamName(const EVHSScalar Param);
+
+	static FName GetParamName(const EVHSVector Param);
+
+	void Wake();
+
+	void UpdateTapeState();
+
+	/** Post-process materials pick their cheaper variants from the QualityTier parameter */
+	UFUNCTION() void HandleQualityTierChanged(int32 Tier);
+
+	void Flush();
+};
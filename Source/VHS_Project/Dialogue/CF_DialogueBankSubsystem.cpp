@@ -0,0 +1,379 @@
+#include "CF_DialogueBankSubsystem.h"
+
+// # Engine Includes
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Engine/GameInstance.h"
+#include "Misc/Crc.h"
+#include "Sound/SoundWave.h"
+
+// # Project Includes
+#include "VHS_Project.h"
+#include "CF_Player.h"
+#include "Subsystems/CF_RandomSubsystem.h"
+
+DECLARE_MEMORY_STAT(TEXT("Dialogue Waves (es)"), STAT_VHS_DialogueMemoryES, STATGROUP_VHS);
+DECLARE_MEMORY_STAT(TEXT("Dialogue Waves (en)"), STAT_VHS_DialogueMemoryEN, STATGROUP_VHS);
+DECLARE_CYCLE_STAT(TEXT("Dialogue Register Layout"), STAT_VHS_DialogueRegisterLayout, STATGROUP_VHS);
+DECLARE_CYCLE_STAT(TEXT("Dialogue Folder Loaded"), STAT_VHS_DialogueFolderLoaded, STATGROUP_VHS);
+DECLARE_CYCLE_STAT(TEXT("Dialogue Language Swap"), STAT_VHS_DialogueLanguageSwap, STATGROUP_VHS);
+
+namespace
+{
+	TArray<USoundWave*> ResolveWaves(const TArray<FSoftObjectPath>& Paths, FCF_RandomStream Stream)
+	{
+		TArray<USoundWave*> waves;
+		waves.Reserve(Paths.Num());
+		for (const auto& path : Paths)
+		{
+			if (auto* wave = Cast<USoundWave>(path.ResolveObject()))
+				waves.Add(wave);
+		}
+
+		ACF_Player::Shuffle(waves, Stream);
+		return waves;
+	}
+
+	int64 GetWavesBytes(const TArray<FSoftObjectPath>& Paths)
+	{
+		int64 bytes = 0;
+		for (const auto& path : Paths)
+		{
+			if (auto* wave = Cast<USoundWave>(path.ResolveObject()))
+				bytes += wave->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+		}
+
+		return bytes;
+	}
+}
+
+void UCF_DialogueBankSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Collection.InitializeDependency<UCF_RandomSubsystem>();
+}
+
+void UCF_DialogueBankSubsystem::Deinitialize()
+{
+	CancelLanguageSwap();
+
+	for (auto& folder : Folders)
+	{
+		if (folder.Value.Handle.IsValid())
+			folder.Value.Handle->CancelHandle();
+	}
+
+	Folders.Empty();
+	Dialogues.Empty();
+	UpdateResidentBytes();
+
+	Super::Deinitialize();
+}
+
+void UCF_DialogueBankSubsystem::RegisterLayout(const FString& RootPath, const TArray<FString>& FolderNames)
+{
+	VHS_SCOPE(DialogueRegisterLayout);
+
+	DialoguesPath = RootPath;
+
+	for (const auto& folderName : FolderNames)
+	{
+		if (Folders.Contains(folderName))
+			continue;
+
+		FDialogueFolder& folder = Folders.Add(folderName);
+		folder.es = FindWavesInFolder(folderName, ELanguage::es);
+		folder.en = FindWavesInFolder(folderName, ELanguage::en);
+	}
+}
+
+void UCF_DialogueBankSubsystem::PrimeState(const EDanielState State)
+{
+	PendingReadyFolders = GetFoldersForState(State);
+	bIsReadyPending = true;
+
+	RequestFolders(PendingReadyFolders, FStreamableManager::AsyncLoadHighPriority);
+
+	TArray<FString> remaining;
+	Folders.GetKeys(remaining);
+	remaining.RemoveAll([this](const FString& folderName) { return PendingReadyFolders.Contains(folderName); });
+	RequestFolders(remaining, FStreamableManager::DefaultAsyncLoadPriority);
+
+	CheckReady();
+}
+
+void UCF_DialogueBankSubsystem::RequestFolders(const TArray<FString>& FolderNames, const TAsyncLoadPriority Priority)
+{
+	for (const auto& folderName : FolderNames)
+	{
+		FDialogueFolder* folder = Folders.Find(folderName);
+		if (!folder || folder->bIsResident)
+			continue;
+
+		if (folder->Handle.IsValid())
+		{
+			// The streamer can't reprioritize a request, a folder still queued in the background is requested again
+			if (Priority <= folder->Priority)
+				continue;
+
+			folder->Handle->CancelHandle();
+			folder->Handle.Reset();
+		}
+		else
+		{
+			folder->RequestTime = FPlatformTime::Seconds();
+		}
+
+		folder->Priority = Priority;
+
+		const TArray<FSoftObjectPath>& paths = folder->GetPaths(ActiveLanguage);
+		if (paths.IsEmpty())
+		{
+			HandleFolderLoaded(folderName);
+			continue;
+		}
+
+		folder->Handle = StreamableManager.RequestAsyncLoad(paths, FStreamableDelegate::CreateUObject(this, &UCF_DialogueBankSubsystem::HandleFolderLoaded, folderName), Priority);
+	}
+}
+
+bool UCF_DialogueBankSubsystem::IsFolderResident(const FString& FolderName) const
+{
+	const FDialogueFolder* folder = Folders.Find(FolderName);
+	return folder && folder->bIsResident;
+}
+
+bool UCF_DialogueBankSubsystem::AreFoldersResident(const TArray<FString>& FolderNames) const
+{
+	for (const auto& folderName : FolderNames)
+	{
+		if (Folders.Contains(folderName) && !IsFolderResident(folderName))
+			return false;
+	}
+
+	return true;
+}
+
+const TArray<USoundWave*>& UCF_DialogueBankSubsystem::GetWaves(const FString& FolderName) const
+{
+	static const TArray<USoundWave*> Empty;
+
+	const FST_Dialogue* dialogue = Dialogues.Find(FolderName);
+	return dialogue ? dialogue->Waves : Empty;
+}
+
+float UCF_DialogueBankSubsystem::GetFolderLoadLatency(const FString& FolderName) const
+{
+	const FDialogueFolder* folder = Folders.Find(FolderName);
+	return folder ? folder->LoadLatency : -1.f;
+}
+
+void UCF_DialogueBankSubsystem::SetLanguage(const ELanguage Language)
+{
+	if (bIsSwapPending && Language == SwapLanguage)
+		return;
+
+	CancelLanguageSwap();
+
+	if (Language == ActiveLanguage)
+		return;
+
+	// Only what is already resident needs to be streamed before the swap, in flight folders are simply re-requested
+	TArray<FString> toSwap;
+	for (const auto& folder : Folders)
+	{
+		if (folder.Value.bIsResident && !folder.Value.GetPaths(Language).IsEmpty())
+			toSwap.Add(folder.Key);
+	}
+
+	bIsSwapPending = true;
+	SwapLanguage = Language;
+	PendingSwapFolders = toSwap.Num();
+
+	if (PendingSwapFolders == 0)
+	{
+		CommitLanguageSwap();
+		return;
+	}
+
+	for (const auto& folderName : toSwap)
+	{
+		FDialogueFolder& folder = Folders[folderName];
+		folder.SwapHandle = StreamableManager.RequestAsyncLoad(folder.GetPaths(Language), FStreamableDelegate::CreateUObject(this, &UCF_DialogueBankSubsystem::HandleSwapFolderLoaded, folderName), folder.Priority);
+	}
+}
+
+TArray<FString> UCF_DialogueBankSubsystem::GetFoldersForState(const EDanielState State)
+{
+	switch (State)
+	{
+	case EDanielState::State2:	return { "Intro", "State2" };
+	case EDanielState::State3:	return { "State3" };
+	case EDanielState::State4:	return { "State4", "State4B" };
+	case EDanielState::State5:	return { "State5" };
+	case EDanielState::State6:	return { "State6", "State6B" };
+	}
+
+	return {};
+}
+
+TArray<FSoftObjectPath> UCF_DialogueBankSubsystem::FindWavesInFolder(const FString& FolderName, const ELanguage Language) const
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	FARFilter filter;
+	filter.PackagePaths.Add(FName(FString::Printf(TEXT("%s%s/%s"), *DialoguesPath, *UEnum::GetValueAsString<ELanguage>(Language), *FolderName)));
+	filter.ClassPaths.Add(USoundWave::StaticClass()->GetClassPathName());
+	filter.bRecursiveClasses = true;
+
+	TArray<FAssetData> data;
+	AssetRegistry.GetAssets(filter, data);
+
+	TArray<FSoftObjectPath> paths;
+	paths.Reserve(data.Num());
+	for (const auto& asset : data)
+		paths.Add(asset.GetSoftObjectPath());
+
+	return paths;
+}
+
+void UCF_DialogueBankSubsystem::HandleFolderLoaded(FString FolderName)
+{
+	VHS_SCOPE(DialogueFolderLoaded);
+
+	FDialogueFolder* folder = Folders.Find(FolderName);
+	if (!folder)
+		return;
+
+	const TArray<FSoftObjectPath>& paths = folder->GetPaths(ActiveLanguage);
+	Dialogues.Add(FolderName, FST_Dialogue(ActiveLanguage, ResolveWaves(paths, MakeFolderStream(FolderName))));
+
+	folder->bIsResident = true;
+	folder->LoadLatency = static_cast<float>(FPlatformTime::Seconds() - folder->RequestTime);
+
+	UE_LOG(LogVHS, Log, TEXT("Dialogue folder '%s' resident in %.2f ms (%d waves)"), *FolderName, folder->LoadLatency * 1000.f, paths.Num());
+
+	UpdateResidentBytes();
+
+	OnFolderResident.Broadcast(FolderName);
+	CheckReady();
+}
+
+void UCF_DialogueBankSubsystem::HandleSwapFolderLoaded(FString FolderName)
+{
+	if (!bIsSwapPending)
+		return;
+
+	UpdateResidentBytes();
+
+	if (--PendingSwapFolders <= 0)
+		CommitLanguageSwap();
+}
+
+void UCF_DialogueBankSubsystem::CancelLanguageSwap()
+{
+	if (!bIsSwapPending)
+		return;
+
+	for (auto& folder : Folders)
+	{
+		if (folder.Value.SwapHandle.IsValid())
+		{
+			folder.Value.SwapHandle->CancelHandle();
+			folder.Value.SwapHandle.Reset();
+		}
+	}
+
+	bIsSwapPending = false;
+	PendingSwapFolders = 0;
+
+	UpdateResidentBytes();
+}
+
+void UCF_DialogueBankSubsystem::CommitLanguageSwap()
+{
+	VHS_SCOPE(DialogueLanguageSwap);
+
+	TArray<FString> toRequest;
+	TArray<FString> toPrioritize;
+
+	// Everything below happens within one game thread call, so no reader ever sees a mix of both languages.
+	// Sounds already playing keep their wave referenced through the audio device until they finish.
+	for (auto& folder : Folders)
+	{
+		FDialogueFolder& data = folder.Value;
+
+		if (data.bIsResident && data.SwapHandle.IsValid())
+		{
+			if (data.Handle.IsValid())
+				data.Handle->ReleaseHandle();
+
+			data.Handle = MoveTemp(data.SwapHandle);
+			Dialogues.Add(folder.Key, FST_Dialogue(SwapLanguage, ResolveWaves(data.GetPaths(SwapLanguage), MakeFolderStream(folder.Key))));
+		}
+		else if (data.bIsResident || data.Handle.IsValid())
+		{
+			// Either still in flight, or it finished in the old language after the swap was requested, so it has nothing streamed in the new one
+			if (data.Handle.IsValid())
+			{
+				if (data.bIsResident)
+					data.Handle->ReleaseHandle();
+				else
+					data.Handle->CancelHandle();
+
+				data.Handle.Reset();
+			}
+
+			data.bIsResident = false;
+			Dialogues.Remove(folder.Key);
+
+			(data.Priority > FStreamableManager::DefaultAsyncLoadPriority ? toPrioritize : toRequest).Add(folder.Key);
+		}
+	}
+
+	ActiveLanguage = SwapLanguage;
+	bIsSwapPending = false;
+	PendingSwapFolders = 0;
+
+	RequestFolders(toPrioritize, FStreamableManager::AsyncLoadHighPriority);
+	RequestFolders(toRequest, FStreamableManager::DefaultAsyncLoadPriority);
+
+	UpdateResidentBytes();
+
+	UE_LOG(LogVHS, Log, TEXT("Dialogue language swapped to '%s' (es: %lld KB, en: %lld KB)"), *UEnum::GetValueAsString<ELanguage>(ActiveLanguage), GetResidentBytes(ELanguage::es) / 1024, GetResidentBytes(ELanguage::en) / 1024);
+
+	OnLanguageChanged.Broadcast(ActiveLanguage);
+}
+
+void UCF_DialogueBankSubsystem::UpdateResidentBytes()
+{
+	ResidentBytes[0] = ResidentBytes[1] = 0;
+
+	for (const auto& folder : Folders)
+	{
+		if (folder.Value.bIsResident)
+			ResidentBytes[static_cast<uint8>(ActiveLanguage)] += GetWavesBytes(folder.Value.GetPaths(ActiveLanguage));
+
+		if (bIsSwapPending && folder.Value.SwapHandle.IsValid() && folder.Value.SwapHandle->HasLoadCompleted())
+			ResidentBytes[static_cast<uint8>(SwapLanguage)] += GetWavesBytes(folder.Value.GetPaths(SwapLanguage));
+	}
+
+	SET_MEMORY_STAT(STAT_VHS_DialogueMemoryES, ResidentBytes[static_cast<uint8>(ELanguage::es)]);
+	SET_MEMORY_STAT(STAT_VHS_DialogueMemoryEN, ResidentBytes[static_cast<uint8>(ELanguage::en)]);
+}
+
+void UCF_DialogueBankSubsystem::CheckReady()
+{
+	if (!bIsReadyPending || !AreFoldersResident(PendingReadyFolders))
+		return;
+
+	bIsReadyPending = false;
+	OnDialoguesReady.Broadcast();
+}
+
+FCF_RandomStream UCF_DialogueBankSubsystem::MakeFolderStream(const FString& FolderName) const
+{
+	// One stream per folder, folders finish streaming in any order
+	return GetGameInstance()->GetSubsystem<UCF_RandomSubsystem>()->MakeStream(TEXT("Dialogue"), FCrc::StrCrc32(*FolderName));
+}
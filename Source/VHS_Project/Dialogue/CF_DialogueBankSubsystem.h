@@ -0,0 +1,128 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Engine/StreamableManager.h"
+
+#include "Dialogue/CF_DialogueTypes.h"
+#include "Utils/CF_RandomStream.h"
+
+#include "CF_DialogueBankSubsystem.generated.h"
+
+// # Engine Forwards
+class USoundWave;
+
+/**
+ * Owns every dialogue wave of the episode. The asset registry is only used to discover the folder layout,
+ * the waves themselves are streamed in on demand, one handle per folder, and only for the active language.
+ */
+UCLASS()
+class VHS_PROJECT_API UCF_DialogueBankSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	/** Fired once every folder requested through PrimeState is resident */
+	FOnDialoguesReady OnDialoguesReady;
+
+	/** Fired every time a folder finishes streaming */
+	FOnDialogueFolderResident OnFolderResident;
+
+	/** Fired after a language swap has been committed */
+	FOnDialogueLanguageChanged OnLanguageChanged;
+
+	/** Reads the asset registry for RootPath/<language>/<folder> without loading anything */
+	void RegisterLayout(const FString& RootPath, const TArray<FString>& FolderNames);
+
+	/** Streams the folders of State first, then every other registered folder in a lower priority batch */
+	void PrimeState(const EDanielState State);
+
+	/** Folders already queued at a lower priority are requested again at Priority */
+	void RequestFolders(const TArray<FString>& FolderNames, const TAsyncLoadPriority Priority);
+
+	bool IsFolderResident(const FString& FolderName) const;
+
+	bool AreFoldersResident(const TArray<FString>& FolderNames) const;
+
+	/** Resident waves of the folder in the active language, empty while the folder is still streaming */
+	const TArray<USoundWave*>& GetWaves(const FString& FolderName) const;
+
+	/** Seconds between the request and the folder becoming resident, negative if it isn't yet */
+	float GetFolderLoadLatency(const FString& FolderName) const;
+
+	/**
+	 * Streams the resident folders in the new language while the current ones keep playing,
+	 * then swaps every folder at once and releases the old language.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Dialogues")
+	void SetLanguage(const ELanguage Language);
+
+	UFUNCTION(BlueprintPure, Category = "Dialogues")
+	ELanguage GetLanguage() const { return ActiveLanguage; }
+
+	/** Bytes held by the resident waves of Language, including a swap still in flight */
+	UFUNCTION(BlueprintPure, Category = "Dialogues")
+	int64 GetResidentBytes(const ELanguage Language) const { return ResidentBytes[static_cast<uint8>(Language)]; }
+
+	static TArray<FString> GetFoldersForState(const EDanielState State);
+
+protected:
+
+	struct FDialogueFolder
+	{
+		TArray<FSoftObjectPath> es;
+		TArray<FSoftObjectPath> en;
+
+		TSharedPtr<FStreamableHandle> Handle;
+		TSharedPtr<FStreamableHandle> SwapHandle;
+
+		TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority;
+		double RequestTime = 0.0;
+		float LoadLatency = -1.f;
+		bool bIsResident = false;
+
+		const TArray<FSoftObjectPath>& GetPaths(const ELanguage Language) const { return Language == ELanguage::es ? es : en; }
+	};
+
+	FStreamableManager StreamableManager;
+
+	FString DialoguesPath;
+
+	TMap<FString, FDialogueFolder> Folders;
+
+	UPROPERTY() TMap<FString, FST_Dialogue> Dialogues;
+
+	TArray<FString> PendingReadyFolders;
+	bool bIsReadyPending = false;
+
+	// Language --->
+	ELanguage ActiveLanguage = ELanguage::es;
+	ELanguage SwapLanguage = ELanguage::es;
+	bool bIsSwapPending = false;
+	int32 PendingSwapFolders = 0;
+
+	int64 ResidentBytes[2] = {};
+
+	// -------------------------------------------------------------------------
+
+	TArray<FSoftObjectPath> FindWavesInFolder(const FString& FolderName, const ELanguage Language) const;
+
+	void HandleFolderLoaded(FString FolderName);
+
+	void HandleSwapFolderLoaded(FString FolderName);
+
+	void CancelLanguageSwap();
+
+	void CommitLanguageSwap();
+
+	void UpdateResidentBytes();
+
+	void CheckReady();
+
+	FCF_RandomStream MakeFolderStream(const FString& FolderName) const;
+};
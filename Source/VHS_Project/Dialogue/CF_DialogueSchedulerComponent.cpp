@@ -0,0 +1,251 @@
+#include "CF_DialogueSchedulerComponent.h"
+
+// # Engine Includes
+#include "Components/AudioComponent.h"
+#include "Engine/GameInstance.h"
+#include "Kismet/GameplayStatics.h"
+#include "Sound/SoundWave.h"
+#include "TimerManager.h"
+
+// # Project Includes
+#include "VHS_Project.h"
+#include "Dialogue/CF_DialogueBankSubsystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("Dialogue Queue"), STAT_VHS_QueueDialogue, STATGROUP_VHS);
+DECLARE_CYCLE_STAT(TEXT("Dialogue Play Next"), STAT_VHS_DialoguePlayNext, STATGROUP_VHS);
+
+UCF_DialogueSchedulerComponent::UCF_DialogueSchedulerComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UCF_DialogueSchedulerComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (auto* bank = GetBank())
+	{
+		DH_FolderResident = bank->OnFolderResident.AddUObject(this, &UCF_DialogueSchedulerComponent::HandleFolderResident);
+		DH_LanguageChanged = bank->OnLanguageChanged.AddUObject(this, &UCF_DialogueSchedulerComponent::HandleLanguageChanged);
+	}
+}
+
+void UCF_DialogueSchedulerComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (auto* bank = GetBank())
+	{
+		bank->OnFolderResident.Remove(DH_FolderResident);
+		bank->OnLanguageChanged.Remove(DH_LanguageChanged);
+	}
+
+	if (auto* world = GetWorld())
+		world->GetTimerManager().ClearTimer(TH_Prefetch);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UCF_DialogueSchedulerComponent::Setup(UAudioComponent* inVoice)
+{
+	Voice = inVoice;
+
+	if (Voice)
+		Voice->OnAudioFinished.AddUniqueDynamic(this, &UCF_DialogueSchedulerComponent::HandleVoiceFinished);
+}
+
+bool UCF_DialogueSchedulerComponent::QueueDialogue(const FString& Folder, const EDanielState State, const bool bInterrupt)
+{
+	VHS_SCOPE(QueueDialogue);
+
+	auto* bank = GetBank();
+	if (!bank)
+		return false;
+
+	const double now = GetWorld()->GetTimeSeconds();
+
+	if (!bInterrupt)
+	{
+		const double* lastRequest = LastRequestTime.Find(Folder);
+		if (lastRequest && now - *lastRequest < FolderCooldown)
+			return false;
+	}
+
+	FDialogueRequest request;
+	request.Folder = Folder;
+	request.State = State;
+	request.bInterrupt = bInterrupt;
+	request.QueuedTime = now;
+
+	// Preemption
+	if (bIsSpeaking && bInterrupt && request.GetPriority() >= Current.GetPriority() && PlayRequest(request))
+	{
+		LastRequestTime.Add(Folder, now);
+		return true;
+	}
+
+	if (Queue.Num() >= MaxQueuedLines)
+	{
+		// The queue is sorted, the last request is the least relevant one
+		if (Queue.Last().GetPriority() >= request.GetPriority())
+			return false;
+
+		Queue.Pop();
+	}
+
+	int32 idx = Queue.IndexOfByPredicate([&request](const FDialogueRequest& queued) { return queued.GetPriority() < request.GetPriority(); });
+	if (idx == INDEX_NONE)
+		idx = Queue.Num();
+
+	Queue.Insert(request, idx);
+	LastRequestTime.Add(Folder, now);
+	bank->RequestFolders({ Folder }, FStreamableManager::AsyncLoadHighPriority);
+
+	if (!bIsSpeaking)
+		PlayNext();
+	else if (idx == 0)
+		Prefetch();
+
+	return true;
+}
+
+void UCF_DialogueSchedulerComponent::StopDialogue(const bool bClearQueue)
+{
+	if (bClearQueue)
+		Queue.Empty();
+
+	GetWorld()->GetTimerManager().ClearTimer(TH_Prefetch);
+
+	if (Voice && Voice->IsPlaying())
+		Voice->Stop();
+	else
+		SetSpeaking(false);
+}
+
+UCF_DialogueBankSubsystem* UCF_DialogueSchedulerComponent::GetBank() const
+{
+	return GetOwner() ? UGameInstance::GetSubsystem<UCF_DialogueBankSubsystem>(GetOwner()->GetGameInstance()) : nullptr;
+}
+
+void UCF_DialogueSchedulerComponent::HandleVoiceFinished()
+{
+	// A preempting line restarts the component before the previous one reports back
+	if (Voice && Voice->IsPlaying())
+		return;
+
+	PlayNext();
+}
+
+void UCF_DialogueSchedulerComponent::HandleFolderResident(const FString& Folder)
+{
+	if (bIsSpeaking)
+		return;
+
+	if (Queue.ContainsByPredicate([&Folder](const FDialogueRequest& queued) { return queued.Folder == Folder; }))
+		PlayNext();
+}
+
+void UCF_DialogueSchedulerComponent::HandleLanguageChanged(ELanguage Language)
+{
+	PrefetchedWave = nullptr;
+
+	if (bIsSpeaking)
+		Prefetch();
+}
+
+void UCF_DialogueSchedulerComponent::PlayNext()
+{
+	VHS_SCOPE(DialoguePlayNext);
+
+	const double now = GetWorld()->GetTimeSeconds();
+	Queue.RemoveAll([this, now](const FDialogueRequest& queued) { return now - queued.QueuedTime > QueueTimeout; });
+
+	// Requests whose folder is still streaming keep their place in the queue
+	for (int32 i = 0; i < Queue.Num(); ++i)
+	{
+		if (!PickWave(Queue[i].Folder, false))
+			continue;
+
+		const FDialogueRequest request = Queue[i];
+		Queue.RemoveAt(i);
+		PlayRequest(request);
+		return;
+	}
+
+	SetSpeaking(false);
+}
+
+bool UCF_DialogueSchedulerComponent::PlayRequest(const FDialogueRequest& Request)
+{
+	if (!Voice)
+		return false;
+
+	USoundWave* wave = PickWave(Request.Folder, true);
+	if (!wave)
+		return false;
+
+	Current = Request;
+
+	Voice->SetSound(wave);
+	Voice->Play();
+	SetSpeaking(true);
+
+	auto& timerManager = GetWorld()->GetTimerManager();
+	const float prefetchDelay = wave->Duration - PrefetchLeadTime;
+	if (prefetchDelay > 0.f)
+		timerManager.SetTimer(TH_Prefetch, this, &UCF_DialogueSchedulerComponent::Prefetch, prefetchDelay, false);
+	else
+	{
+		timerManager.ClearTimer(TH_Prefetch);
+		Prefetch();
+	}
+
+	return true;
+}
+
+void UCF_DialogueSchedulerComponent::Prefetch()
+{
+	// With nothing queued the most likely next line is another one of the current folder
+	const FString& folder = Queue.Num() > 0 ? Queue[0].Folder : Current.Folder;
+
+	USoundWave* wave = PickWave(folder, false);
+	if (!wave)
+	{
+		if (auto* bank = GetBank())
+			bank->RequestFolders({ folder }, FStreamableManager::AsyncLoadHighPriority);
+		return;
+	}
+
+	if (wave == PrefetchedWave)
+		return;
+
+	PrefetchedWave = wave;
+	UGameplayStatics::PrimeSound(wave);
+}
+
+USoundWave* UCF_DialogueSchedulerComponent::PickWave(const FString& Folder, const bool bConsume)
+{
+	auto* bank = GetBank();
+	if (!bank)
+		return nullptr;
+
+	// The bank shuffles every folder once it's resident, walking it in order never repeats a line until the pool is exhausted
+	const TArray<USoundWave*>& waves = bank->GetWaves(Folder);
+	if (waves.IsEmpty())
+		return nullptr;
+
+	int32& cursor = PoolCursor.FindOrAdd(Folder);
+	USoundWave* wave = waves[cursor % waves.Num()];
+
+	if (bConsume)
+		cursor = (cursor + 1) % waves.Num();
+
+	return wave;
+}
+
+void UCF_DialogueSchedulerComponent::SetSpeaking(const bool bInIsSpeaking)
+{
+	if (bIsSpeaking == bInIsSpeaking)
+		return;
+
+	bIsSpeaking = bInIsSpeaking;
+	OnSpeakingChanged.Broadcast(bIsSpeaking);
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+
+#include "Dialogue/CF_DialogueTypes.h"
+
+#include "CF_DialogueSchedulerComponent.generated.h"
+
+// # Engine Forwards
+class UAudioComponent;
+class USoundWave;
+
+// # Project Forwards
+class UCF_DialogueBankSubsystem;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnSpeakingChanged, bool)
+
+struct FDialogueRequest
+{
+	FString Folder;
+	EDanielState State = EDanielState::State2;
+	bool bInterrupt = false;
+	double QueuedTime = 0.0;
+
+	uint8 GetPriority() const { return static_cast<uint8>(State); }
+};
+
+/**
+ * Plays the voice lines of the player one at a time. Requests are kept in a bounded queue ordered by
+ * EDanielState, later states win. The next wave is primed before the current line ends so lines chain without gaps.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class VHS_PROJECT_API UCF_DialogueSchedulerComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UCF_DialogueSchedulerComponent();
+
+	FOnSpeakingChanged OnSpeakingChanged;
+
+	void Setup(UAudioComponent* inVoice);
+
+	/**
+	 * Queues a random line of Folder. Interrupting requests cut the current line if their state is at least as high,
+	 * the rest wait for their turn. Returns false if the request was rejected by the cooldown or a full queue.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Dialogues")
+	bool QueueDialogue(const FString& Folder, const EDanielState State, const bool bInterrupt = false);
+
+	UFUNCTION(BlueprintCallable, Category = "Dialogues")
+	void StopDialogue(const bool bClearQueue = true);
+
+	UFUNCTION(BlueprintPure, Category = "Dialogues")
+	bool IsSpeaking() const { return bIsSpeaking; }
+
+protected:
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Dialogues")
+	int32 MaxQueuedLines = 4;
+
+	/** Seconds before the same folder can be requested again, interrupting requests ignore it */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Dialogues")
+	float FolderCooldown = 8.f;
+
+	/** Seconds a request can wait in the queue before it's no longer relevant */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Dialogues")
+	float QueueTimeout = 10.f;
+
+	/** Seconds before the end of the current line at which the next wave is primed */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "CustomProperties | Dialogues")
+	float PrefetchLeadTime = 1.5f;
+
+	UPROPERTY() UAudioComponent* Voice = nullptr;
+
+	UPROPERTY() USoundWave* PrefetchedWave = nullptr;
+
+	TArray<FDialogueRequest> Queue;
+	FDialogueRequest Current;
+	bool bIsSpeaking = false;
+
+	TMap<FString, double> LastRequestTime;
+	TMap<FString, int32> PoolCursor;
+
+	FTimerHandle TH_Prefetch;
+
+	FDelegateHandle DH_FolderResident;
+	FDelegateHandle DH_LanguageChanged;
+
+	// -------------------------------------------------------------------------
+
+	UCF_DialogueBankSubsystem* GetBank() const;
+
+	UFUNCTION() void HandleVoiceFinished();
+
+	void HandleFolderResident(const FString& Folder);
+
+	void HandleLanguageChanged(ELanguage Language);
+
+	void PlayNext();
+
+	bool PlayRequest(const FDialogueRequest& Request);
+
+	void Prefetch();
+
+	USoundWave* PickWave(const FString& Folder, const bool bConsume);
+
+	void SetSpeaking(const bool bInIsSpeaking);
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "CF_DialogueTypes.generated.h"
+
+class USoundWave;
+
+DECLARE_MULTICAST_DELEGATE(FOnDialoguesReady)
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnDialogueFolderResident, const FString&)
+
+UENUM(BlueprintType)
+enum class ELanguage : uint8
+{
+	es = 0	UMETA(DisplayName = "es"),
+	en = 1	UMETA(DisplayName = "en")
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnDialogueLanguageChanged, ELanguage)
+
+UENUM(BlueprintType)
+enum class EDanielState : uint8
+{
+	State2 = 0		UMETA(DisplayName = "State 2"),
+	State3 = 1		UMETA(DisplayName = "State 3"),
+	State4 = 2		UMETA(DisplayName = "State 4"),
+	State5 = 3		UMETA(DisplayName = "State 5"),
+	State6 = 4		UMETA(DisplayName = "State 6"),
+};
+
+USTRUCT(BlueprintType)
+struct FST_Dialogue
+{
+	GENERATED_BODY()
+
+	UPROPERTY() ELanguage Language = ELanguage::es;
+	UPROPERTY() TArray<USoundWave*> Waves = {};
+
+	FST_Dialogue() {}
+
+	FST_Dialogue(const ELanguage inLanguage, const TArray<USoundWave*>& inWaves) : Language(inLanguage), Waves(inWaves) {}
+};
@@ -1,35 +1,37 @@
 #include "Flashlight.h"
 
 #include "Components/SpotLightComponent.h"
-#include "Curves/CurveFloat.h"
+#include "TimerManager.h"
+
+#include "VHS_Project.h"
+#include "Lighting/CF_FlickerSubsystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("Flashlight Start Flickering"), STAT_VHS_FlashlightFlicker, STATGROUP_VHS);
 
 AFlashlight::AFlashlight()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bCanEverTick = false;
 
 	Root = CreateDefaultSubobject<USceneComponent>("Scene");
 	SetRootComponent(Root);
 	SpotLight = CreateDefaultSubobject<USpotLightComponent>("SpotLight");
 	SpotLight->SetupAttachment(RootComponent);
-
-	TL_Flickering = CreateDefaultSubobject<UTimelineComponent>(TEXT("TL_Flickering"));
 }
 
 void AFlashlight::StartFlickering()
 {
-	if (!TL_Flickering)
-		return;
+	VHS_SCOPE(FlashlightFlicker);
 
-	int32 idx = FMath::RandRange(0, FlickerCurves.Num() - 1);
-	TL_Flickering->SetFloatCurve(FlickerCurves[idx], TEXT("Alpha"));
-	TL_Flickering->SetPlayRate(FMath::RandRange(0.6f, 1.f));
-	TL_Flickering->PlayFromStart();
+	if (auto* flicker = GetWorld()->GetSubsystem<UCF_FlickerSubsystem>())
+		flicker->SetFlickering(FlickerHandle, true);
 }
 
 void AFlashlight::StopFlickering()
 {
-	if (TL_Flickering)
-		TL_Flickering->Stop();
+	GetWorldTimerManager().ClearTimer(TH_TimedFlickering);
+
+	if (auto* flicker = GetWorld()->GetSubsystem<UCF_FlickerSubsystem>())
+		flicker->SetFlickering(FlickerHandle, false);
 
 	CheckEndFlickering();
 }
@@ -45,29 +47,22 @@ void AFlashlight::BeginPlay()
 	Super::BeginPlay();
 	
 	SwitchLight(bIsLightOn);
-	TimelineFlickeringFloatFn.BindUFunction(this, FName("HandleTL"));
-	TimelineFlickeringFinishedFn.BindUFunction(this, FName("StartFlickering"));
 
-	TL_Flickering->SetTimelineFinishedFunc(TimelineFlickeringFinishedFn);
-
-	UCurveFloat* Curve = NewObject<UCurveFloat>(this, UCurveFloat::StaticClass(), TEXT("FloatCurve"));
-	Curve->FloatCurve.UpdateOrAddKey(0.f, 0.f);
-	Curve->FloatCurve.UpdateOrAddKey(.5f, 1.f);
-	Curve->FloatCurve.UpdateOrAddKey(1.f, 0.f);
-	
-	TL_Flickering->AddInterpFloat(Curve, TimelineFlickeringFloatFn, FName("Alpha"));
-	TL_Flickering->SetLooping(false);
-	TL_Flickering->SetIgnoreTimeDilation(true);
+	// The flashlight follows the camera, it's never culled
+	if (auto* flicker = GetWorld()->GetSubsystem<UCF_FlickerSubsystem>())
+		FlickerHandle = flicker->RegisterLight(SpotLight, FlickerCurves, LightIntensity, false, true);
 }
 
-void AFlashlight::HandleTL(float Value)
+void AFlashlight::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	UpdateIntensity(Value);
-}
+	GetWorldTimerManager().ClearTimer(TH_TimedFlickering);
 
-void AFlashlight::UpdateIntensity(const float Alpha)
-{
-	SpotLight->SetIntensity(Alpha * LightIntensity);
+	if (auto* flicker = GetWorld()->GetSubsystem<UCF_FlickerSubsystem>())
+		flicker->UnregisterLight(FlickerHandle);
+
+	FlickerHandle = INDEX_NONE;
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AFlashlight::SwitchLight(const bool bIsOn)
@@ -77,19 +72,11 @@ void AFlashlight::SwitchLight(const bool bIsOn)
 
 void AFlashlight::TimedFlickering(const float Duration)
 {
-	FTimerHandle TH_Flicker;
 	StartFlickering();
-	GetWorld()->GetTimerManager().SetTimer(TH_Flicker, FTimerDelegate::CreateLambda([this]() { StopFlickering(); }), Duration, false);
+	GetWorldTimerManager().SetTimer(TH_TimedFlickering, this, &AFlashlight::StopFlickering, Duration, false);
 }
 
 void AFlashlight::CheckEndFlickering()
 {
 	SwitchLight(bIsLightOn);
 }
-
-void AFlashlight::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-
-}
-
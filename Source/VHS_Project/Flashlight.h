@@ -2,7 +2,6 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
-#include "Components/TimelineComponent.h"
 
 #include "Flashlight.generated.h"
 
@@ -29,10 +28,14 @@ public:
 
 	void ToggleFlashlight();
 
+	bool IsLightOn() const { return bIsLightOn; }
+
 protected:
 	
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	float LightIntensity = 50000.f;
 
 	bool bIsLightOn = false;
@@ -40,25 +43,16 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	TArray<UCurveFloat*> FlickerCurves = {};
 
-	UTimelineComponent* TL_Flickering;
+	/** Handle in UCF_FlickerSubsystem, which plays the flicker */
+	int32 FlickerHandle = INDEX_NONE;
 
-	FOnTimelineFloat TimelineFlickeringFloatFn;
-	FOnTimelineEventStatic TimelineFlickeringFinishedFn;
+	FTimerHandle TH_TimedFlickering;
 
 	// ----------------------------------------------------
 
-	UFUNCTION() void HandleTL(float Value);
-
-	void UpdateIntensity(const float Alpha);
-
 	void SwitchLight(const bool bIsOn);
 
 	void TimedFlickering(const float Duration);
 
 	void CheckEndFlickering();
-
-public:	
-	
-	virtual void Tick(float DeltaTime) override;
-
 };
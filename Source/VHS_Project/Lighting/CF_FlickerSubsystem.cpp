@@ -0,0 +1,343 @@
+#include "CF_FlickerSubsystem.h"
+
+// # Engine Includes
+#include "Camera/PlayerCameraManager.h"
+#include "Components/LightComponent.h"
+#include "Curves/CurveFloat.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/App.h"
+
+// # Project Includes
+#include "VHS_Project.h"
+#include "Subsystems/CF_RandomSubsystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("Flicker Tick"), STAT_VHS_FlickerTick, STATGROUP_VHS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Flickering Lights"), STAT_VHS_FlickeringLights, STATGROUP_VHS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Flicker Intensity Pushes"), STAT_VHS_FlickerPushes, STATGROUP_VHS);
+DECLARE_MEMORY_STAT(TEXT("Flicker Tables"), STAT_VHS_FlickerTableMemory, STATGROUP_VHS);
+
+namespace FlickerHandles
+{
+	constexpr int32 SlotBits = 16;
+	constexpr int32 SlotMask = (1 << SlotBits) - 1;
+	constexpr uint16 GenerationMask = 0x7FFF;
+
+	int32 Make(const int32 Slot, const uint16 Generation) { return (static_cast<int32>(Generation) << SlotBits) | Slot; }
+	int32 GetSlot(const int32 Handle) { return Handle & SlotMask; }
+	uint16 GetGeneration(const int32 Handle) { return static_cast<uint16>(Handle >> SlotBits); }
+}
+
+void UCF_FlickerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Stream = UCF_RandomSubsystem::MakeStreamFor(this, TEXT("Flicker"));
+
+	// Table 0 is the fallback for lights registered without curves
+	Tables.AddDefaulted_GetRef().BuildDefault();
+	INC_MEMORY_STAT_BY(STAT_VHS_FlickerTableMemory, Tables[0].GetAllocatedSize());
+}
+
+void UCF_FlickerSubsystem::Deinitialize()
+{
+	for (const auto& table : Tables)
+		DEC_MEMORY_STAT_BY(STAT_VHS_FlickerTableMemory, table.GetAllocatedSize());
+
+	Tables.Empty();
+	TableLookup.Empty();
+
+	Super::Deinitialize();
+}
+
+int32 UCF_FlickerSubsystem::RegisterLight(ULightComponent* Light, const TArray<UCurveFloat*>& Curves, const float BaseIntensity, const bool bStartFlickering, const bool bNeverCull)
+{
+	if (!Light)
+		return INDEX_NONE;
+
+	const int32 index = Lights.Add(Light);
+	Phases.Add(0.f);
+	PlayRates.Add(1.f);
+	TableIndices.Add(0);
+	CurveSetIndices.Add(FindOrAddCurveSet(Curves));
+	BaseIntensities.Add(BaseIntensity);
+	PushedIntensities.Add(Light->Intensity);
+	TimeSinceUpdate.Add(0.f);
+	Flags.Add(bNeverCull ? LF_NeverCull : 0);
+
+	int32 slot;
+	if (FreeSlots.Num() > 0)
+	{
+		slot = FreeSlots.Pop(false);
+	}
+	else
+	{
+		check(HandleToIndex.Num() <= FlickerHandles::SlotMask);
+		slot = HandleToIndex.AddUninitialized();
+		SlotGenerations.Add(0);
+	}
+
+	HandleToIndex[slot] = index;
+
+	const int32 handle = FlickerHandles::Make(slot, SlotGenerations[slot]);
+	IndexToHandle.Add(handle);
+
+	if (bStartFlickering)
+		SetFlickering(handle, true);
+
+	return handle;
+}
+
+void UCF_FlickerSubsystem::UnregisterLight(const int32 Handle)
+{
+	const int32 index = GetIndex(Handle);
+	if (index != INDEX_NONE)
+		RemoveAt(index);
+}
+
+void UCF_FlickerSubsystem::SetFlickering(const int32 Handle, const bool bFlickering)
+{
+	const int32 index = GetIndex(Handle);
+	if (index == INDEX_NONE || bFlickering == IsFlickering(Handle))
+		return;
+
+	if (bFlickering)
+	{
+		Flags[index] |= LF_Flickering;
+		PickCurve(index, Stream.FRand(), Stream.FRand());
+		return;
+	}
+
+	Flags[index] &= ~LF_Flickering;
+
+	// Back to the resting intensity, owners with their own on/off state override it afterwards
+	if (ULightComponent* light = Lights[index].Get())
+	{
+		PushedIntensities[index] = BaseIntensities[index];
+		light->SetIntensity(BaseIntensities[index]);
+	}
+}
+
+void UCF_FlickerSubsystem::SetBaseIntensity(const int32 Handle, const float BaseIntensity)
+{
+	const int32 index = GetIndex(Handle);
+	if (index != INDEX_NONE)
+		BaseIntensities[index] = BaseIntensity;
+}
+
+bool UCF_FlickerSubsystem::IsFlickering(const int32 Handle) const
+{
+	const int32 index = GetIndex(Handle);
+	return index != INDEX_NONE && (Flags[index] & LF_Flickering) != 0;
+}
+
+void UCF_FlickerSubsystem::Tick(float DeltaTime)
+{
+	VHS_SCOPE(FlickerTick);
+
+	Super::Tick(DeltaTime);
+
+	const int32 num = Lights.Num();
+	if (num == 0)
+		return;
+
+	// Undilated, the flicker ignores time dilation
+	const float deltaTime = static_cast<float>(FApp::GetDeltaTime());
+
+	// Advance every phase in one pass, wrapping lights pick their next curve
+	for (int32 i = 0; i < num; ++i)
+	{
+		const float flickering = (Flags[i] & LF_Flickering) ? 1.f : 0.f;
+		Phases[i] += deltaTime * PlayRates[i] * flickering;
+		TimeSinceUpdate[i] += deltaTime;
+	}
+
+	TArray<int32, TInlineAllocator<16>> wrappedLights;
+	for (int32 i = 0; i < num; ++i)
+	{
+		if ((Flags[i] & LF_Flickering) && Phases[i] >= Tables[TableIndices[i]].GetDuration())
+			wrappedLights.Add(i);
+	}
+
+	// Two rolls per wrapped light, drawn in one batch
+	if (wrappedLights.Num() > 0)
+	{
+		TArray<float, TInlineAllocator<32>> rolls;
+		rolls.SetNumUninitialized(wrappedLights.Num() * 2);
+		Stream.FillRange(rolls);
+
+		for (int32 i = 0; i < wrappedLights.Num(); ++i)
+			PickCurve(wrappedLights[i], rolls[i * 2], rolls[i * 2 + 1]);
+	}
+
+	FVector viewLocation = FVector::ZeroVector;
+	FVector viewDirection = FVector::ForwardVector;
+	float viewHalfAngle = PI;
+	bool bHasView = false;
+
+	if (const APlayerController* pc = GetWorld()->GetFirstPlayerController())
+	{
+		if (const APlayerCameraManager* camera = pc->PlayerCameraManager)
+		{
+			viewLocation = camera->GetCameraLocation();
+			viewDirection = camera->GetCameraRotation().Vector();
+			viewHalfAngle = FMath::DegreesToRadians(camera->GetFOVAngle() * .5f);
+			bHasView = true;
+		}
+	}
+
+	uint32 numFlickering = 0;
+	uint32 numPushes = 0;
+	TArray<int32, TInlineAllocator<8>> staleLights;
+
+	for (int32 i = 0; i < num; ++i)
+	{
+		// Lights destroyed while not flickering are swept as well, their slots would otherwise leak
+		ULightComponent* light = Lights[i].Get();
+		if (!light)
+		{
+			staleLights.Add(i);
+			continue;
+		}
+
+		if (!(Flags[i] & LF_Flickering))
+			continue;
+
+		++numFlickering;
+
+		if (bHasView && !(Flags[i] & LF_NeverCull))
+		{
+			const FSphere bounds = light->GetBoundingSphere();
+			const FVector toLight = bounds.Center - viewLocation;
+			const float distance = toLight.Size();
+
+			if (distance - bounds.W > CullDistance)
+				continue;
+
+			// Camera outside the radius of the light, cull it if the whole sphere is behind the view cone
+			if (distance > bounds.W)
+			{
+				const float angle = FMath::Acos(FVector::DotProduct(viewDirection, toLight / distance));
+				if (angle - FMath::Asin(bounds.W / distance) > viewHalfAngle)
+					continue;
+			}
+
+			if (distance - bounds.W > NearDistance && TimeSinceUpdate[i] < FarUpdateRate)
+				continue;
+		}
+
+		TimeSinceUpdate[i] = 0.f;
+
+		const float alpha = Tables[TableIndices[i]].Evaluate(Phases[i]);
+		const float intensity = alpha * BaseIntensities[i];
+
+		// Changes below the threshold aren't visible, the extremes are always pushed
+		const bool bIsExtreme = alpha <= 0.f || alpha >= 1.f;
+		if (!bIsExtreme && FMath::Abs(intensity - PushedIntensities[i]) < IntensityThreshold * BaseIntensities[i])
+			continue;
+
+		if (intensity == PushedIntensities[i])
+			continue;
+
+		PushedIntensities[i] = intensity;
+		light->SetIntensity(intensity);
+		++numPushes;
+	}
+
+	for (int32 i = staleLights.Num() - 1; i >= 0; --i)
+		RemoveAt(staleLights[i]);
+
+	SET_DWORD_STAT(STAT_VHS_FlickeringLights, numFlickering);
+	SET_DWORD_STAT(STAT_VHS_FlickerPushes, numPushes);
+}
+
+TStatId UCF_FlickerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCF_FlickerSubsystem, STATGROUP_Tickables);
+}
+
+bool UCF_FlickerSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+int32 UCF_FlickerSubsystem::FindOrAddTable(UCurveFloat* Curve)
+{
+	if (!Curve)
+		return 0;
+
+	if (const int32* found = TableLookup.Find(Curve))
+		return *found;
+
+	const int32 index = Tables.AddDefaulted();
+	Tables[index].Build(Curve->FloatCurve);
+	TableLookup.Add(Curve, index);
+
+	INC_MEMORY_STAT_BY(STAT_VHS_FlickerTableMemory, Tables[index].GetAllocatedSize());
+
+	return index;
+}
+
+int32 UCF_FlickerSubsystem::FindOrAddCurveSet(const TArray<UCurveFloat*>& Curves)
+{
+	TArray<int32> curveSet;
+	for (UCurveFloat* curve : Curves)
+	{
+		if (curve)
+			curveSet.AddUnique(FindOrAddTable(curve));
+	}
+
+	if (curveSet.IsEmpty())
+		curveSet.Add(0);
+
+	// Lights placed from the same blueprint share their set
+	const int32 found = CurveSets.IndexOfByKey(curveSet);
+	return found != INDEX_NONE ? found : CurveSets.Add(MoveTemp(curveSet));
+}
+
+int32 UCF_FlickerSubsystem::GetIndex(const int32 Handle) const
+{
+	if (Handle < 0)
+		return INDEX_NONE;
+
+	const int32 slot = FlickerHandles::GetSlot(Handle);
+	if (!HandleToIndex.IsValidIndex(slot) || SlotGenerations[slot] != FlickerHandles::GetGeneration(Handle))
+		return INDEX_NONE;
+
+	return HandleToIndex[slot];
+}
+
+void UCF_FlickerSubsystem::PickCurve(const int32 Index, const float CurveRoll, const float RateRoll)
+{
+	const TArray<int32>& curveSet = CurveSets[CurveSetIndices[Index]];
+
+	TableIndices[Index] = curveSet[FMath::Min(static_cast<int32>(CurveRoll * curveSet.Num()), curveSet.Num() - 1)];
+	PlayRates[Index] = FMath::Lerp(.6f, 1.f, RateRoll);
+	Phases[Index] = 0.f;
+}
+
+void UCF_FlickerSubsystem::RemoveAt(const int32 Index)
+{
+	const int32 handle = IndexToHandle[Index];
+	const int32 lastHandle = IndexToHandle.Last();
+
+	Lights.RemoveAtSwap(Index, 1, false);
+	Phases.RemoveAtSwap(Index, 1, false);
+	PlayRates.RemoveAtSwap(Index, 1, false);
+	TableIndices.RemoveAtSwap(Index, 1, false);
+	CurveSetIndices.RemoveAtSwap(Index, 1, false);
+	BaseIntensities.RemoveAtSwap(Index, 1, false);
+	PushedIntensities.RemoveAtSwap(Index, 1, false);
+	TimeSinceUpdate.RemoveAtSwap(Index, 1, false);
+	Flags.RemoveAtSwap(Index, 1, false);
+	IndexToHandle.RemoveAtSwap(Index, 1, false);
+
+	// The last light took the removed slot
+	const int32 slot = FlickerHandles::GetSlot(handle);
+	HandleToIndex[FlickerHandles::GetSlot(lastHandle)] = Index;
+	HandleToIndex[slot] = INDEX_NONE;
+
+	// Invalidates the handle the owner still holds
+	SlotGenerations[slot] = (SlotGenerations[slot] + 1) & FlickerHandles::GenerationMask;
+	FreeSlots.Add(slot);
+}
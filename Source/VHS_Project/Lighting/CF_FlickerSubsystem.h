@@ -0,0 +1,112 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "Lighting/CF_FlickerTable.h"
+#include "Utils/CF_RandomStream.h"
+
+#include "CF_FlickerSubsystem.generated.h"
+
+// # Engine Forwards
+class ULightComponent;
+class UCurveFloat;
+
+/**
+ * Plays the flicker of every registered light in the level. Light state lives in parallel arrays so the whole
+ * level advances in one tight pass per frame. Lights outside the view or far from it are skipped or updated at a
+ * lower rate, and intensity is only pushed to the render thread when the change would be visible.
+ */
+UCLASS()
+class VHS_PROJECT_API UCF_FlickerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	/**
+	 * Registers Light with the curves it can pick from, BaseIntensity is the intensity at alpha 1.
+	 * Lights that never cull (e.g. the flashlight) are updated every frame wherever the camera is.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Flicker")
+	int32 RegisterLight(ULightComponent* Light, const TArray<UCurveFloat*>& Curves, const float BaseIntensity, const bool bStartFlickering = true, const bool bNeverCull = false);
+
+	UFUNCTION(BlueprintCallable, Category = "Flicker")
+	void UnregisterLight(const int32 Handle);
+
+	UFUNCTION(BlueprintCallable, Category = "Flicker")
+	void SetFlickering(const int32 Handle, const bool bFlickering);
+
+	UFUNCTION(BlueprintCallable, Category = "Flicker")
+	void SetBaseIntensity(const int32 Handle, const float BaseIntensity);
+
+	UFUNCTION(BlueprintPure, Category = "Flicker")
+	bool IsFlickering(const int32 Handle) const;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Lights further than this from the camera are not updated */
+	float CullDistance = 5000.f;
+
+	/** Lights further than this are updated at FarUpdateRate */
+	float NearDistance = 1500.f;
+
+	float FarUpdateRate = 1.f / 15.f;
+
+	/** Fraction of the base intensity the light has to move before it's pushed to the render thread */
+	float IntensityThreshold = .02f;
+
+	FCF_RandomStream Stream;
+
+	// Shared tables --->
+	TArray<FCF_FlickerTable> Tables;
+	TMap<TObjectKey<UCurveFloat>, int32> TableLookup;
+	TArray<TArray<int32>> CurveSets;
+
+	// Per light, indexed densely --->
+	TArray<TWeakObjectPtr<ULightComponent>> Lights;
+	TArray<float> Phases;
+	TArray<float> PlayRates;
+	TArray<int32> TableIndices;
+	TArray<int32> CurveSetIndices;
+	TArray<float> BaseIntensities;
+	TArray<float> PushedIntensities;
+	TArray<float> TimeSinceUpdate;
+	TArray<uint8> Flags;
+
+	// Handle <-> dense index. A handle is a slot plus the slot's generation, so a handle kept by an owner after its
+	// light was swept as stale can't resolve to whatever light reuses the slot later
+	TArray<int32> HandleToIndex;
+	TArray<uint16> SlotGenerations;
+	TArray<int32> IndexToHandle;
+	TArray<int32> FreeSlots;
+
+	enum ELightFlags : uint8
+	{
+		LF_Flickering = 1 << 0,
+		LF_NeverCull = 1 << 1
+	};
+
+	// -------------------------------------------------------------------------
+
+	int32 FindOrAddTable(UCurveFloat* Curve);
+
+	int32 FindOrAddCurveSet(const TArray<UCurveFloat*>& Curves);
+
+	int32 GetIndex(const int32 Handle) const;
+
+	/** CurveRoll and RateRoll are uniform in [0, 1) */
+	void PickCurve(const int32 Index, const float CurveRoll, const float RateRoll);
+
+	void RemoveAt(const int32 Index);
+};
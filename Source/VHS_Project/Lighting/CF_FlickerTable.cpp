@@ -0,0 +1,53 @@
+#include "CF_FlickerTable.h"
+
+// # Engine Includes
+#include "Curves/RichCurve.h"
+
+void FCF_FlickerTable::Build(const FRichCurve& Curve)
+{
+	Samples.Reset();
+
+	float startTime = 0.f;
+	float endTime = 0.f;
+	Curve.GetTimeRange(startTime, endTime);
+
+	float maxValue = 0.f;
+	Curve.GetValueRange(MinValue, maxValue);
+
+	Duration = FMath::Max(endTime - startTime, 0.f);
+	ValueRange = maxValue - MinValue;
+
+	const int32 numSamples = FMath::CeilToInt32(Duration * SampleRate) + 1;
+	Samples.SetNumUninitialized(numSamples);
+
+	for (int32 i = 0; i < numSamples; ++i)
+	{
+		const float value = Curve.Eval(startTime + FMath::Min(i / SampleRate, Duration));
+		const float alpha = ValueRange > UE_KINDA_SMALL_NUMBER ? (value - MinValue) / ValueRange : 0.f;
+
+		Samples[i] = static_cast<uint8>(FMath::RoundToInt32(FMath::Clamp(alpha, 0.f, 1.f) * 255.f));
+	}
+}
+
+void FCF_FlickerTable::BuildDefault()
+{
+	FRichCurve curve;
+	curve.UpdateOrAddKey(0.f, 0.f);
+	curve.UpdateOrAddKey(.5f, 1.f);
+	curve.UpdateOrAddKey(1.f, 0.f);
+
+	Build(curve);
+}
+
+float FCF_FlickerTable::Evaluate(const float Time) const
+{
+	if (Samples.IsEmpty())
+		return 0.f;
+
+	const float position = FMath::Clamp(Time, 0.f, Duration) * SampleRate;
+	const int32 a = FMath::Min(FMath::FloorToInt32(position), Samples.Num() - 1);
+	const int32 b = FMath::Min(a + 1, Samples.Num() - 1);
+
+	const float sample = FMath::Lerp(static_cast<float>(Samples[a]), static_cast<float>(Samples[b]), position - a);
+	return MinValue + sample / 255.f * ValueRange;
+}
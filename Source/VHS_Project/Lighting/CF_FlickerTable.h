@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// # Engine Forwards
+struct FRichCurve;
+
+/**
+ * A flicker curve baked into evenly spaced 8 bit samples. Sampling is a lerp between two bytes, cheap enough to
+ * evaluate for every light in the level each frame and small enough to share between all of them.
+ */
+struct VHS_PROJECT_API FCF_FlickerTable
+{
+	/** Samples per second of curve time */
+	static constexpr float SampleRate = 60.f;
+
+	void Build(const FRichCurve& Curve);
+
+	/** 0 -> 1 -> 0 over one second, used when no curve has been authored */
+	void BuildDefault();
+
+	/** Time is clamped to the length of the curve */
+	float Evaluate(const float Time) const;
+
+	float GetDuration() const { return Duration; }
+
+	SIZE_T GetAllocatedSize() const { return Samples.GetAllocatedSize(); }
+
+private:
+
+	TArray<uint8> Samples;
+
+	float Duration = 0.f;
+	float MinValue = 0.f;
+	float ValueRange = 0.f;
+};
@@ -0,0 +1,144 @@
+#include "CF_ClearanceSubsystem.h"
+
+// # Engine Includes
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+
+// # Project Includes
+#include "VHS_Project.h"
+
+DECLARE_CYCLE_STAT(TEXT("Clearance Tick"), STAT_VHS_ClearanceTick, STATGROUP_VHS);
+
+void UCF_ClearanceSubsystem::Register(ACharacter* Character, const float StandingHalfHeight, const ECollisionChannel Channel)
+{
+	if (!Character)
+		return;
+
+	int32 idx = FindEntry(Character);
+	if (idx == INDEX_NONE)
+	{
+		// Reuse a free slot, indices are handed to the physics scene as user data
+		idx = Entries.IndexOfByPredicate([](const FClearanceEntry& entry) { return !entry.Character.IsValid(); });
+		if (idx == INDEX_NONE)
+			idx = Entries.AddDefaulted();
+	}
+
+	FClearanceEntry& entry = Entries[idx];
+	entry = FClearanceEntry();
+	entry.Character = Character;
+	entry.StandingHalfHeight = StandingHalfHeight;
+	entry.Channel = Channel;
+}
+
+void UCF_ClearanceSubsystem::Unregister(ACharacter* Character)
+{
+	const int32 idx = FindEntry(Character);
+	if (idx != INDEX_NONE)
+		Entries[idx] = FClearanceEntry();
+}
+
+void UCF_ClearanceSubsystem::SetActive(ACharacter* Character, const bool bActive)
+{
+	const int32 idx = FindEntry(Character);
+	if (idx == INDEX_NONE)
+		return;
+
+	FClearanceEntry& entry = Entries[idx];
+	entry.bActive = bActive;
+
+	if (!bActive)
+		entry.Result = EClearance::Unknown;
+}
+
+EClearance UCF_ClearanceSubsystem::GetClearance(const ACharacter* Character) const
+{
+	const int32 idx = FindEntry(Character);
+	if (idx == INDEX_NONE)
+		return EClearance::Unknown;
+
+	const FClearanceEntry& entry = Entries[idx];
+	if (entry.Result == EClearance::Unknown || !FVector::PointsAreNear(entry.ResultLocation, GetStandingLocation(entry), CacheTolerance))
+		return EClearance::Unknown;
+
+	return entry.Result;
+}
+
+void UCF_ClearanceSubsystem::Tick(float DeltaTime)
+{
+	VHS_SCOPE(ClearanceTick);
+
+	Super::Tick(DeltaTime);
+
+	UWorld* world = GetWorld();
+	if (!world)
+		return;
+
+	if (!OverlapDelegate.IsBound())
+		OverlapDelegate.BindUObject(this, &UCF_ClearanceSubsystem::HandleOverlapResult);
+
+	for (int32 i = 0; i < Entries.Num(); ++i)
+	{
+		FClearanceEntry& entry = Entries[i];
+
+		ACharacter* character = entry.Character.Get();
+		if (!character || !entry.bActive || world->IsTraceHandleValid(entry.PendingQuery, true))
+			continue;
+
+		const float radius = character->GetCapsuleComponent()->GetScaledCapsuleRadius();
+		entry.PendingLocation = GetStandingLocation(entry);
+
+		FCollisionQueryParams params(SCENE_QUERY_STAT(CF_Clearance), true, character);
+		entry.PendingQuery = world->AsyncOverlapByChannel(entry.PendingLocation, FQuat::Identity, entry.Channel, FCollisionShape::MakeCapsule(radius, entry.StandingHalfHeight), params, FCollisionResponseParams::DefaultResponseParam, &OverlapDelegate, static_cast<uint32>(i));
+	}
+}
+
+TStatId UCF_ClearanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCF_ClearanceSubsystem, STATGROUP_Tickables);
+}
+
+bool UCF_ClearanceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+int32 UCF_ClearanceSubsystem::FindEntry(const ACharacter* Character) const
+{
+	if (!Character)
+		return INDEX_NONE;
+
+	return Entries.IndexOfByPredicate([Character](const FClearanceEntry& entry) { return entry.Character.Get() == Character; });
+}
+
+FVector UCF_ClearanceSubsystem::GetStandingLocation(const FClearanceEntry& Entry) const
+{
+	const ACharacter* character = Entry.Character.Get();
+	if (!character)
+		return FVector::ZeroVector;
+
+	const float halfHeight = character->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	return character->GetActorLocation() + FVector(0, 0, Entry.StandingHalfHeight - halfHeight);
+}
+
+void UCF_ClearanceSubsystem::HandleOverlapResult(const FTraceHandle& TraceHandle, FOverlapDatum& Datum)
+{
+	const int32 idx = static_cast<int32>(Datum.UserData);
+	if (!Entries.IsValidIndex(idx))
+		return;
+
+	FClearanceEntry& entry = Entries[idx];
+	if (entry.PendingQuery != TraceHandle || !entry.Character.IsValid())
+		return;
+
+	entry.PendingQuery = FTraceHandle();
+
+	if (!entry.bActive)
+		return;
+
+	const bool bIsBlocked = Datum.OutOverlaps.ContainsByPredicate([](const FOverlapResult& overlap) { return overlap.bBlockingHit; });
+	entry.Result = bIsBlocked ? EClearance::Blocked : EClearance::Clear;
+	entry.ResultLocation = entry.PendingLocation;
+
+	OnClearanceUpdated.Broadcast(entry.Character.Get(), entry.Result);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+
+#include "CF_ClearanceSubsystem.generated.h"
+
+// # Engine Forwards
+class ACharacter;
+
+enum class EClearance : uint8
+{
+	Unknown,
+	Clear,
+	Blocked
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnClearanceUpdated, ACharacter*, EClearance)
+
+/**
+ * Answers "can this character stand up here" without blocking on physics. While a registered character is active
+ * an async overlap for its standing capsule is issued every frame, the latest result is cached with the capsule
+ * location it was computed for and is only trusted while the character stays close to it.
+ */
+UCLASS()
+class VHS_PROJECT_API UCF_ClearanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	FOnClearanceUpdated OnClearanceUpdated;
+
+	void Register(ACharacter* Character, const float StandingHalfHeight, const ECollisionChannel Channel = ECC_Visibility);
+
+	void Unregister(ACharacter* Character);
+
+	/** Inactive characters keep their slot but stop issuing queries, e.g. while standing */
+	void SetActive(ACharacter* Character, const bool bActive);
+
+	EClearance GetClearance(const ACharacter* Character) const;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Max distance in cm between the cached query and the capsule for the result to be reused */
+	float CacheTolerance = 5.f;
+
+	struct FClearanceEntry
+	{
+		TWeakObjectPtr<ACharacter> Character;
+		float StandingHalfHeight = 0.f;
+		ECollisionChannel Channel = ECC_Visibility;
+		bool bActive = false;
+
+		FTraceHandle PendingQuery;
+		FVector PendingLocation = FVector::ZeroVector;
+
+		EClearance Result = EClearance::Unknown;
+		FVector ResultLocation = FVector::ZeroVector;
+	};
+
+	TArray<FClearanceEntry> Entries;
+
+	FOverlapDelegate OverlapDelegate;
+
+	// -------------------------------------------------------------------------
+
+	int32 FindEntry(const ACharacter* Character) const;
+
+	FVector GetStandingLocation(const FClearanceEntry& Entry) const;
+
+	void HandleOverlapResult(const FTraceHandle& TraceHandle, FOverlapDatum& Datum);
+};
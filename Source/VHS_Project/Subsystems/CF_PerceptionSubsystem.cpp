@@ -0,0 +1,224 @@
+#include "CF_PerceptionSubsystem.h"
+
+// # Engine Includes
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+
+// # Project Includes
+#include "VHS_Project.h"
+#include "CF_Player.h"
+#include "Components/CF_GhostPerceptionComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Perception Tick"), STAT_VHS_PerceptionTick, STATGROUP_VHS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Perception Updates"), STAT_VHS_PerceptionUpdates, STATGROUP_VHS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Perception Traces"), STAT_VHS_PerceptionTraces, STATGROUP_VHS);
+
+void UCF_PerceptionSubsystem::Register(UCF_GhostPerceptionComponent* Component)
+{
+	if (!Component)
+		return;
+
+	int32 idx = FindEntry(Component);
+	if (idx == INDEX_NONE)
+	{
+		// Reuse a free slot, indices are handed to the physics scene as user data
+		idx = Entries.IndexOfByPredicate([](const FPerceptionEntry& entry) { return !entry.Component.IsValid(); });
+		if (idx == INDEX_NONE)
+			idx = Entries.AddDefaulted();
+	}
+
+	FPerceptionEntry& entry = Entries[idx];
+	entry = FPerceptionEntry();
+	entry.Component = Component;
+	entry.bActive = true;
+
+	// Spread ghosts registered together over their interval
+	entry.NextUpdateTime = GetWorld()->GetTimeSeconds() + Component->GetUpdateInterval() * FMath::Frac(idx * .618034f);
+}
+
+void UCF_PerceptionSubsystem::Unregister(UCF_GhostPerceptionComponent* Component)
+{
+	const int32 idx = FindEntry(Component);
+	if (idx != INDEX_NONE)
+		Entries[idx] = FPerceptionEntry();
+}
+
+void UCF_PerceptionSubsystem::SetActive(UCF_GhostPerceptionComponent* Component, const bool bActive)
+{
+	const int32 idx = FindEntry(Component);
+	if (idx == INDEX_NONE)
+		return;
+
+	FPerceptionEntry& entry = Entries[idx];
+	entry.bActive = bActive;
+
+	// Time spent disabled isn't integrated on the way back
+	entry.LastUpdateTime = -1.0;
+	entry.VisibleMask = 0;
+}
+
+void UCF_PerceptionSubsystem::Tick(float DeltaTime)
+{
+	VHS_SCOPE(PerceptionTick);
+
+	Super::Tick(DeltaTime);
+
+	const int32 num = Entries.Num();
+	if (num == 0)
+		return;
+
+	FPerceptionTarget target;
+	if (!GatherTarget(target))
+		return;
+
+	if (!TraceDelegate.IsBound())
+		TraceDelegate.BindUObject(this, &UCF_PerceptionSubsystem::HandleTraceResult);
+
+	const double now = GetWorld()->GetTimeSeconds();
+	int32 numUpdates = 0;
+	int32 numTraces = 0;
+	int32 nextCursor = Cursor;
+
+	for (int32 n = 0; n < num && numUpdates < MaxUpdatesPerFrame; ++n)
+	{
+		const int32 i = (Cursor + n) % num;
+		const FPerceptionEntry& entry = Entries[i];
+
+		// A batch still in flight is folded in once it's back
+		if (!entry.Component.IsValid() || !entry.bActive || now < entry.NextUpdateTime || HasPendingTraces(entry))
+			continue;
+
+		numTraces += UpdateEntry(i, target, now);
+		++numUpdates;
+		nextCursor = (i + 1) % num;
+	}
+
+	Cursor = nextCursor;
+
+	SET_DWORD_STAT(STAT_VHS_PerceptionUpdates, numUpdates);
+	SET_DWORD_STAT(STAT_VHS_PerceptionTraces, numTraces);
+}
+
+TStatId UCF_PerceptionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCF_PerceptionSubsystem, STATGROUP_Tickables);
+}
+
+bool UCF_PerceptionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+float UCF_PerceptionSubsystem::GetMaxAwareness() const
+{
+	float awareness = 0.f;
+	for (const auto& entry : Entries)
+	{
+		if (const UCF_GhostPerceptionComponent* component = entry.Component.Get())
+			awareness = FMath::Max(awareness, component->GetAwareness());
+	}
+
+	return awareness;
+}
+
+int32 UCF_PerceptionSubsystem::FindEntry(const UCF_GhostPerceptionComponent* Component) const
+{
+	if (!Component)
+		return INDEX_NONE;
+
+	return Entries.IndexOfByPredicate([Component](const FPerceptionEntry& entry) { return entry.Component.Get() == Component; });
+}
+
+bool UCF_PerceptionSubsystem::GatherTarget(FPerceptionTarget& OutTarget) const
+{
+	const APlayerController* pc = GetWorld()->GetFirstPlayerController();
+	ACF_Player* player = pc ? Cast<ACF_Player>(pc->GetPawn()) : nullptr;
+	if (!player)
+		return false;
+
+	const float radius = player->GetCapsuleComponent()->GetScaledCapsuleRadius();
+
+	OutTarget.Player = player;
+
+	// The camera carries the lean and crouch offsets, the capsule stays behind the corner
+	OutTarget.Points[TP_Head] = player->GetHeadLocation();
+	OutTarget.Radii[TP_Head] = radius * .5f;
+	OutTarget.Exposure[TP_Head] = player->IsPlayerLeaning() ? LeanExposure : 1.f;
+
+	OutTarget.Points[TP_Body] = player->GetActorLocation();
+	OutTarget.Radii[TP_Body] = radius;
+	// Behind the corner the body is never traced, only the head counts
+	OutTarget.Exposure[TP_Body] = player->IsPlayerLeaning() ? 0.f : 1.f;
+
+	OutTarget.RangeScale = (player->IsPlayerCrouching() ? CrouchRangeScale : 1.f) * (player->IsFlashlightOn() ? LitRangeScale : 1.f);
+
+	return true;
+}
+
+bool UCF_PerceptionSubsystem::HasPendingTraces(const FPerceptionEntry& Entry) const
+{
+	for (const FTraceHandle& trace : Entry.PendingTraces)
+	{
+		if (trace.IsValid())
+			return true;
+	}
+
+	return false;
+}
+
+int32 UCF_PerceptionSubsystem::UpdateEntry(const int32 Idx, const FPerceptionTarget& Target, const double Now)
+{
+	FPerceptionEntry& entry = Entries[Idx];
+	UCF_GhostPerceptionComponent* component = entry.Component.Get();
+
+	float stimulus = 0.f;
+	for (int32 p = 0; p < TP_Num; ++p)
+	{
+		if (entry.VisibleMask & (1 << p))
+			stimulus = FMath::Max(stimulus, entry.Factors[p]);
+	}
+
+	if (entry.LastUpdateTime >= 0.0)
+		component->Integrate(stimulus, static_cast<float>(Now - entry.LastUpdateTime));
+
+	entry.LastUpdateTime = Now;
+	entry.NextUpdateTime = Now + component->GetUpdateInterval();
+	entry.VisibleMask = 0;
+
+	const FVector eye = component->GetComponentLocation();
+
+	FCollisionQueryParams params(SCENE_QUERY_STAT(CF_Perception), false, component->GetOwner());
+	params.AddIgnoredActor(Target.Player);
+
+	int32 numTraces = 0;
+	for (int32 p = 0; p < TP_Num; ++p)
+	{
+		entry.Factors[p] = component->GetSightFactor(Target.Points[p], Target.Radii[p], Target.RangeScale) * Target.Exposure[p];
+		if (entry.Factors[p] <= 0.f)
+			continue;
+
+		entry.PendingTraces[p] = GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Test, eye, Target.Points[p], component->GetTraceChannel(), params, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, static_cast<uint32>(Idx * TP_Num + p));
+		++numTraces;
+	}
+
+	return numTraces;
+}
+
+void UCF_PerceptionSubsystem::HandleTraceResult(const FTraceHandle& TraceHandle, FTraceDatum& Datum)
+{
+	const int32 idx = static_cast<int32>(Datum.UserData) / TP_Num;
+	const int32 point = static_cast<int32>(Datum.UserData) % TP_Num;
+	if (!Entries.IsValidIndex(idx))
+		return;
+
+	FPerceptionEntry& entry = Entries[idx];
+	if (entry.PendingTraces[point] != TraceHandle)
+		return;
+
+	entry.PendingTraces[point] = FTraceHandle();
+
+	// Test traces only report whether something blocked the way
+	if (Datum.OutHits.IsEmpty())
+		entry.VisibleMask |= 1 << point;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+
+#include "CF_PerceptionSubsystem.generated.h"
+
+// # Project Forwards
+class ACF_Player;
+class UCF_GhostPerceptionComponent;
+
+/**
+ * Runs the sight of every ghost against the player in one batch. A ghost that's due folds in the line of sight
+ * results of its previous check, tests the player's head and body against its cones and only queues async traces
+ * for the points inside them, so a ghost facing away costs a few dot products and no physics.
+ */
+UCLASS()
+class VHS_PROJECT_API UCF_PerceptionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	void Register(UCF_GhostPerceptionComponent* Component);
+
+	void Unregister(UCF_GhostPerceptionComponent* Component);
+
+	void SetActive(UCF_GhostPerceptionComponent* Component, const bool bActive);
+
+	/** Awareness of the ghost closest to spotting the player, 0 with no ghosts */
+	float GetMaxAwareness() const;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Sight ranges are scaled by these while the player crouches or has the flashlight on */
+	float CrouchRangeScale = .6f;
+	float LitRangeScale = 1.5f;
+
+	/** Only the head shows while leaning around a corner, and only this much of it */
+	float LeanExposure = .5f;
+
+	/** Ghosts due past this many in a frame wait for the next one */
+	int32 MaxUpdatesPerFrame = 8;
+
+	enum ETargetPoint : uint8
+	{
+		TP_Head,
+		TP_Body,
+		TP_Num
+	};
+
+	struct FPerceptionTarget
+	{
+		ACF_Player* Player = nullptr;
+		FVector Points[TP_Num];
+		float Radii[TP_Num] = {};
+		float Exposure[TP_Num] = {};
+		float RangeScale = 1.f;
+	};
+
+	struct FPerceptionEntry
+	{
+		TWeakObjectPtr<UCF_GhostPerceptionComponent> Component;
+		bool bActive = false;
+
+		double NextUpdateTime = 0.0;
+		double LastUpdateTime = -1.0;
+
+		/** Sight factor of each point when its trace was issued */
+		float Factors[TP_Num] = {};
+		FTraceHandle PendingTraces[TP_Num];
+		uint8 VisibleMask = 0;
+	};
+
+	TArray<FPerceptionEntry> Entries;
+
+	/** First entry looked at next frame, ghosts over the per-frame cap aren't starved */
+	int32 Cursor = 0;
+
+	FTraceDelegate TraceDelegate;
+
+	// -------------------------------------------------------------------------
+
+	int32 FindEntry(const UCF_GhostPerceptionComponent* Component) const;
+
+	bool GatherTarget(FPerceptionTarget& OutTarget) const;
+
+	bool HasPendingTraces(const FPerceptionEntry& Entry) const;
+
+	/** Returns the number of traces issued */
+	int32 UpdateEntry(const int32 Idx, const FPerceptionTarget& Target, const double Now);
+
+	void HandleTraceResult(const FTraceHandle& TraceHandle, FTraceDatum& Datum);
+};
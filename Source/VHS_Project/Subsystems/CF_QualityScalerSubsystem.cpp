@@ -0,0 +1,162 @@
+#include "CF_QualityScalerSubsystem.h"
+
+// # Engine Includes
+#include "Engine/World.h"
+#include "GameFramework/GameUserSettings.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "RenderCore.h"
+#include "RHI.h"
+
+// # Project Includes
+#include "VHS_Project.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Quality Tier"), STAT_VHS_QualityTier, STATGROUP_VHS);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Quality Budget (ms)"), STAT_VHS_QualityBudget, STATGROUP_VHS);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Quality GPU Time (ms)"), STAT_VHS_QualityGPUTime, STATGROUP_VHS);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Quality Game Time (ms)"), STAT_VHS_QualityGameTime, STATGROUP_VHS);
+DECLARE_CYCLE_STAT(TEXT("Quality Scaler Tick"), STAT_VHS_QualityScalerTick, STATGROUP_VHS);
+
+namespace QualityTiers
+{
+	struct FTierSetting
+	{
+		const TCHAR* Name;
+
+		/** Ceiling for tiers 1 to MaxTier, negative keeps the ceiling of the previous tier */
+		float Values[UCF_QualityScalerSubsystem::MaxTier];
+	};
+
+	// Cheapest first: resolution, then the distance field and shadow cost, then the post-process stack
+	const FTierSetting Settings[] =
+	{
+		{ TEXT("r.ScreenPercentage"), { 85.f, 75.f, 65.f } },
+		{ TEXT("r.DistanceFieldAO"), { -1.f, 0.f, 0.f } },
+		{ TEXT("sg.ShadowQuality"), { -1.f, 2.f, 1.f } },
+		{ TEXT("sg.PostProcessQuality"), { -1.f, -1.f, 1.f } },
+	};
+}
+
+void UCF_QualityScalerSubsystem::Deinitialize()
+{
+	ApplyTier(0);
+
+	Super::Deinitialize();
+}
+
+void UCF_QualityScalerSubsystem::SetEnabled(const bool bInEnabled)
+{
+	bIsEnabled = bInEnabled;
+	MissTime = 0.f;
+	HeadroomTime = 0.f;
+
+	if (!bIsEnabled)
+		ApplyTier(0);
+}
+
+void UCF_QualityScalerSubsystem::Tick(float DeltaTime)
+{
+	VHS_SCOPE(QualityScalerTick);
+
+	Super::Tick(DeltaTime);
+
+	const float budget = GetBudgetMs();
+	const float gpuTime = FPlatformTime::ToMilliseconds(RHIGetGPUFrameCycles());
+	const float gameTime = FPlatformTime::ToMilliseconds(GGameThreadTime);
+
+	GPUTime = FMath::Lerp(GPUTime, gpuTime, Smoothing);
+	GameTime = FMath::Lerp(GameTime, gameTime, Smoothing);
+
+	SET_FLOAT_STAT(STAT_VHS_QualityBudget, budget);
+	SET_FLOAT_STAT(STAT_VHS_QualityGPUTime, GPUTime);
+	SET_FLOAT_STAT(STAT_VHS_QualityGameTime, GameTime);
+	SET_DWORD_STAT(STAT_VHS_QualityTier, Tier);
+
+	if (!bIsEnabled)
+		return;
+
+	// Lowering render quality can't help a game thread bound frame, only the GPU drives the way down
+	const float frameTime = FMath::Max(GPUTime, GameTime);
+	const float realDelta = static_cast<float>(FApp::GetDeltaTime());
+
+	MissTime = GPUTime > budget * DownscaleThreshold ? MissTime + realDelta : 0.f;
+	HeadroomTime = frameTime < budget * UpscaleThreshold ? HeadroomTime + realDelta : 0.f;
+
+	if (MissTime >= DownscaleDelay && Tier < MaxTier)
+		ApplyTier(Tier + 1);
+	else if (HeadroomTime >= UpscaleDelay && Tier > 0)
+		ApplyTier(Tier - 1);
+}
+
+TStatId UCF_QualityScalerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCF_QualityScalerSubsystem, STATGROUP_Tickables);
+}
+
+bool UCF_QualityScalerSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+float UCF_QualityScalerSubsystem::GetBudgetMs() const
+{
+	// The settings menu writes the E_FPSLimits choice into the frame rate limit
+	const UGameUserSettings* settings = UGameUserSettings::GetGameUserSettings();
+	const float limit = settings ? settings->GetFrameRateLimit() : 0.f;
+
+	return 1000.f / (limit > 0.f ? limit : DefaultTargetFPS);
+}
+
+void UCF_QualityScalerSubsystem::ApplyTier(const int32 NewTier)
+{
+	MissTime = 0.f;
+	HeadroomTime = 0.f;
+
+	if (NewTier == Tier)
+		return;
+
+	// What the player chose is captured each time the scaler leaves tier 0, settings changed meanwhile are kept
+	if (Tier == 0)
+	{
+		DefaultValues.Reset();
+
+		for (const auto& setting : QualityTiers::Settings)
+		{
+			if (IConsoleVariable* cvar = IConsoleManager::Get().FindConsoleVariable(setting.Name))
+				DefaultValues.Add(setting.Name, { cvar->GetFloat(), static_cast<EConsoleVariableFlags>(cvar->GetFlags() & ECVF_SetByMask) });
+		}
+	}
+
+	for (const auto& setting : QualityTiers::Settings)
+	{
+		IConsoleVariable* cvar = IConsoleManager::Get().FindConsoleVariable(setting.Name);
+		const FCapturedValue* captured = DefaultValues.Find(setting.Name);
+		if (!cvar || !captured)
+			continue;
+
+		float ceiling = -1.f;
+		for (int32 i = NewTier - 1; i >= 0 && ceiling < 0.f; --i)
+			ceiling = setting.Values[i];
+
+		if (ceiling >= 0.f)
+		{
+			// A tier only ever lowers quality, a player already below it keeps their choice
+			const float value = FMath::Min(captured->Value, ceiling);
+			if (cvar->GetFloat() != value)
+				cvar->Set(*FString::SanitizeFloat(value), ECVF_SetByCode);
+		}
+		else if ((cvar->GetFlags() & ECVF_SetByMask) == ECVF_SetByCode)
+		{
+			// Restored at the priority the player's value had, so the settings menu can change it again
+			cvar->SetFlags(static_cast<EConsoleVariableFlags>((cvar->GetFlags() & ~ECVF_SetByMask) | captured->Priority));
+			cvar->Set(*FString::SanitizeFloat(captured->Value), captured->Priority);
+		}
+	}
+
+	UE_LOG(LogVHS, Log, TEXT("Quality tier %d -> %d (GPU %.2fms, game %.2fms, budget %.2fms)"), Tier, NewTier, GPUTime, GameTime, GetBudgetMs());
+
+	Tier = NewTier;
+	SET_DWORD_STAT(STAT_VHS_QualityTier, Tier);
+
+	OnQualityTierChanged.Broadcast(Tier);
+}
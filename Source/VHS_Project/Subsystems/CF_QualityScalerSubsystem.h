@@ -0,0 +1,87 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "CF_QualityScalerSubsystem.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnQualityTierChanged, int32, Tier);
+
+/**
+ * Keeps the frame inside the budget set by the frame rate limit. The smoothed GPU and game thread times are compared
+ * with the budget, a sustained miss steps one tier down and a sustained margin steps one tier back up.
+ * Tier 0 is what the player chose, each tier above it caps a few more settings below that choice. The blur widget
+ * isn't scaled natively, UMG_VHS_Blur has to lower its own resolution from OnQualityTierChanged.
+ */
+UCLASS(Config = Game)
+class VHS_PROJECT_API UCF_QualityScalerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	/** Fired after the console variables of the new tier are applied, widgets and materials adapt from here */
+	UPROPERTY(BlueprintAssignable, Category = "Quality")
+	FOnQualityTierChanged OnQualityTierChanged;
+
+	UFUNCTION(BlueprintPure, Category = "Quality")
+	int32 GetTier() const { return Tier; }
+
+	UFUNCTION(BlueprintCallable, Category = "Quality")
+	void SetEnabled(const bool bInEnabled);
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	static constexpr int32 MaxTier = 3;
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Used while the frame rate limit is unlimited */
+	UPROPERTY(Config) float DefaultTargetFPS = 60.f;
+
+	/** Budget multiplier above which the frame counts as a miss */
+	UPROPERTY(Config) float DownscaleThreshold = 1.05f;
+
+	/** Budget multiplier under which the frame counts as having headroom */
+	UPROPERTY(Config) float UpscaleThreshold = .8f;
+
+	/** Seconds of sustained miss before stepping down */
+	UPROPERTY(Config) float DownscaleDelay = 2.f;
+
+	/** Seconds of sustained headroom before stepping up, longer than the way down so tiers don't oscillate */
+	UPROPERTY(Config) float UpscaleDelay = 8.f;
+
+	/** Weight of the newest frame in the smoothed frame times */
+	UPROPERTY(Config) float Smoothing = .1f;
+
+	int32 Tier = 0;
+	bool bIsEnabled = true;
+
+	float GPUTime = 0.f;
+	float GameTime = 0.f;
+
+	float MissTime = 0.f;
+	float HeadroomTime = 0.f;
+
+	struct FCapturedValue
+	{
+		float Value = 0.f;
+		EConsoleVariableFlags Priority = ECVF_SetByConstructor;
+	};
+
+	/** Values and set-by priorities the tiered console variables had when the scaler left tier 0 */
+	TMap<FString, FCapturedValue> DefaultValues;
+
+	// -------------------------------------------------------------------------
+
+	float GetBudgetMs() const;
+
+	void ApplyTier(const int32 NewTier);
+};
@@ -0,0 +1,48 @@
+#include "CF_RandomSubsystem.h"
+
+// # Engine Includes
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Crc.h"
+#include "Misc/Parse.h"
+
+// # Project Includes
+#include "VHS_Project.h"
+#include "Benchmark/CF_InputReplaySubsystem.h"
+
+void UCF_RandomSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const TCHAR* cmd = FCommandLine::Get();
+
+	FString replayPath;
+	if (!FParse::Value(cmd, TEXT("VHSSeed="), SessionSeed)
+		&& !(FParse::Value(cmd, TEXT("VHSReplay="), replayPath) && UCF_InputReplaySubsystem::ReadSeed(replayPath, SessionSeed)))
+		SessionSeed = static_cast<int32>(FPlatformTime::Cycles());
+
+	// Engine code and anything not moved to a stream yet still draws from FMath::Rand
+	FMath::RandInit(SessionSeed);
+	FMath::SRandInit(SessionSeed);
+
+	UE_LOG(LogVHS, Log, TEXT("Random: session seed %d"), SessionSeed);
+}
+
+FCF_RandomStream UCF_RandomSubsystem::MakeStream(const FName System, const uint32 Key) const
+{
+	// FName hashes aren't stable between runs, the string is
+	const uint32 sequence = HashCombine(FCrc::StrCrc32(*System.ToString()), Key);
+	return FCF_RandomStream(static_cast<uint32>(SessionSeed), sequence);
+}
+
+FCF_RandomStream UCF_RandomSubsystem::MakeStreamFor(const UObject* WorldContextObject, const FName System, const uint32 Key)
+{
+	const UWorld* world = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	const UGameInstance* gameInstance = world ? world->GetGameInstance() : nullptr;
+
+	if (const auto* random = gameInstance ? gameInstance->GetSubsystem<UCF_RandomSubsystem>() : nullptr)
+		return random->MakeStream(System, Key);
+
+	return FCF_RandomStream(FPlatformTime::Cycles64(), FCrc::StrCrc32(*System.ToString()));
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+
+#include "Utils/CF_RandomStream.h"
+
+#include "CF_RandomSubsystem.generated.h"
+
+/**
+ * Owns the session seed every gameplay random stream derives from. The seed comes from -VHSSeed=, from the header
+ * of the recording passed with -VHSReplay= or from the clock, in that order. Systems ask once for a stream named
+ * after themselves and draw from it without touching any shared state.
+ */
+UCLASS()
+class VHS_PROJECT_API UCF_RandomSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	UFUNCTION(BlueprintPure, Category = "Random")
+	int32 GetSessionSeed() const { return SessionSeed; }
+
+	/** Same System and Key give the same sequence for the same session seed, whatever order they are created in */
+	FCF_RandomStream MakeStream(const FName System, const uint32 Key = 0) const;
+
+	/** MakeStream through the game instance of WorldContextObject, unseeded outside of a game */
+	static FCF_RandomStream MakeStreamFor(const UObject* WorldContextObject, const FName System, const uint32 Key = 0);
+
+protected:
+
+	int32 SessionSeed = 0;
+};
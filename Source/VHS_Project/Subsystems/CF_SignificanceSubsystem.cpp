@@ -0,0 +1,234 @@
+#include "CF_SignificanceSubsystem.h"
+
+// # Engine Includes
+#include "AIController.h"
+#include "BrainComponent.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+
+// # Project Includes
+#include "VHS_Project.h"
+#include "Components/CF_GhostPerceptionComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Significance Tick"), STAT_VHS_SignificanceTick, STATGROUP_VHS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ghosts High"), STAT_VHS_GhostsHigh, STATGROUP_VHS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ghosts Medium"), STAT_VHS_GhostsMedium, STATGROUP_VHS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ghosts Low"), STAT_VHS_GhostsLow, STATGROUP_VHS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ghosts Dormant"), STAT_VHS_GhostsDormant, STATGROUP_VHS);
+
+namespace SignificanceBuckets
+{
+	struct FBucket
+	{
+		/** Lowest score in the bucket */
+		float MinScore;
+
+		/** Behaviour tree, controller and skeletal mesh, 0 is every frame */
+		float TickInterval;
+
+		float PerceptionRateScale;
+
+		/** Animation frames skipped between two updates, interpolated */
+		int32 AnimFrameSkip;
+
+		bool bEvaluateAimOffset;
+
+		/** Pose only ticks while rendered */
+		bool bOnlyTickWhenRendered;
+	};
+
+	const FBucket Buckets[] =
+	{
+		{ .7f,	0.f,	1.f,	0,	true,	false },	// High
+		{ .4f,	.1f,	.5f,	1,	true,	false },	// Medium
+		{ .1f,	.25f,	.2f,	3,	false,	true },		// Low
+		{ 0.f,	1.f,	.05f,	7,	false,	true },		// Dormant
+	};
+
+	static_assert(UE_ARRAY_COUNT(Buckets) == static_cast<int32>(ESignificance::MAX), "One bucket per significance");
+
+	const FBucket& Get(const ESignificance Significance)
+	{
+		return Buckets[static_cast<int32>(Significance)];
+	}
+}
+
+void UCF_SignificanceSubsystem::Register(UCF_GhostPerceptionComponent* Perception)
+{
+	AActor* ghost = Perception ? Perception->GetOwner() : nullptr;
+	if (!ghost || FindEntry(ghost) != INDEX_NONE)
+		return;
+
+	FSignificanceEntry& entry = Entries.AddDefaulted_GetRef();
+	entry.Perception = Perception;
+	entry.Ghost = ghost;
+
+	if (auto* mesh = ghost->FindComponentByClass<USkeletalMeshComponent>())
+	{
+		entry.Mesh = mesh;
+		entry.AuthoredTickOption = static_cast<uint8>(mesh->VisibilityBasedAnimTickOption);
+		mesh->bEnableUpdateRateOptimizations = true;
+	}
+
+	// Scored with the next batch
+	TimeToScore = 0.f;
+}
+
+void UCF_SignificanceSubsystem::Unregister(UCF_GhostPerceptionComponent* Perception)
+{
+	const int32 idx = Entries.IndexOfByPredicate([Perception](const FSignificanceEntry& entry) { return entry.Perception.Get() == Perception; });
+	if (idx != INDEX_NONE)
+		Entries.RemoveAtSwap(idx);
+}
+
+ESignificance UCF_SignificanceSubsystem::GetSignificance(const AActor* Ghost) const
+{
+	const int32 idx = FindEntry(Ghost);
+	return idx != INDEX_NONE && Entries[idx].Bucket != ESignificance::MAX ? Entries[idx].Bucket : ESignificance::High;
+}
+
+bool UCF_SignificanceSubsystem::ShouldEvaluateAimOffset(const AActor* Ghost) const
+{
+	return SignificanceBuckets::Get(GetSignificance(Ghost)).bEvaluateAimOffset;
+}
+
+void UCF_SignificanceSubsystem::Tick(float DeltaTime)
+{
+	VHS_SCOPE(SignificanceTick);
+
+	Super::Tick(DeltaTime);
+
+	TimeToScore -= DeltaTime;
+	if (TimeToScore > 0.f || Entries.IsEmpty())
+		return;
+
+	TimeToScore = ScoreInterval;
+
+	const APlayerController* pc = GetWorld()->GetFirstPlayerController();
+	if (!pc || !pc->PlayerCameraManager)
+		return;
+
+	const FVector viewLocation = pc->PlayerCameraManager->GetCameraLocation();
+	uint32 counts[static_cast<int32>(ESignificance::MAX)] = {};
+
+	for (int32 i = Entries.Num() - 1; i >= 0; --i)
+	{
+		FSignificanceEntry& entry = Entries[i];
+		if (!entry.Ghost.IsValid() || !entry.Perception.IsValid())
+		{
+			Entries.RemoveAtSwap(i);
+			continue;
+		}
+
+		entry.Score = ComputeScore(entry, viewLocation);
+
+		const ESignificance bucket = ComputeBucket(entry, entry.Score);
+		if (bucket != entry.Bucket)
+			ApplyBucket(entry, bucket);
+
+		++counts[static_cast<int32>(entry.Bucket)];
+	}
+
+	SET_DWORD_STAT(STAT_VHS_GhostsHigh, counts[static_cast<int32>(ESignificance::High)]);
+	SET_DWORD_STAT(STAT_VHS_GhostsMedium, counts[static_cast<int32>(ESignificance::Medium)]);
+	SET_DWORD_STAT(STAT_VHS_GhostsLow, counts[static_cast<int32>(ESignificance::Low)]);
+	SET_DWORD_STAT(STAT_VHS_GhostsDormant, counts[static_cast<int32>(ESignificance::Dormant)]);
+}
+
+TStatId UCF_SignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCF_SignificanceSubsystem, STATGROUP_Tickables);
+}
+
+bool UCF_SignificanceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+int32 UCF_SignificanceSubsystem::FindEntry(const AActor* Ghost) const
+{
+	if (!Ghost)
+		return INDEX_NONE;
+
+	return Entries.IndexOfByPredicate([Ghost](const FSignificanceEntry& entry) { return entry.Ghost.Get() == Ghost; });
+}
+
+float UCF_SignificanceSubsystem::ComputeScore(const FSignificanceEntry& Entry, const FVector& ViewLocation) const
+{
+	const AActor* ghost = Entry.Ghost.Get();
+
+	const float distance = FVector::Dist(ghost->GetActorLocation(), ViewLocation);
+	const float distanceScore = 1.f - FMath::Clamp(distance / MaxDistance, 0.f, 1.f);
+
+	return ghost->WasRecentlyRendered(ScoreInterval) ? distanceScore : distanceScore * HiddenScale;
+}
+
+ESignificance UCF_SignificanceSubsystem::ComputeBucket(const FSignificanceEntry& Entry, const float Score) const
+{
+	// The state outranks the distance, a chasing ghost behind the camera still has to act and animate at full rate
+	const EGhostState state = Entry.Perception->GetGhostState();
+	if (state == EGhostState::Alerted)
+		return ESignificance::High;
+
+	const int32 current = static_cast<int32>(Entry.Bucket);
+
+	int32 bucket = static_cast<int32>(ESignificance::Dormant);
+	for (int32 i = 0; i < static_cast<int32>(ESignificance::MAX); ++i)
+	{
+		// Staying in the current bucket or a more significant one is easier than entering it
+		const float threshold = SignificanceBuckets::Buckets[i].MinScore - (i >= current ? Hysteresis : 0.f);
+		if (Score >= threshold)
+		{
+			bucket = i;
+			break;
+		}
+	}
+
+	if (state == EGhostState::Suspicious)
+		bucket = FMath::Min(bucket, static_cast<int32>(ESignificance::Medium));
+
+	return static_cast<ESignificance>(bucket);
+}
+
+void UCF_SignificanceSubsystem::ApplyBucket(FSignificanceEntry& Entry, const ESignificance Bucket)
+{
+	Entry.Bucket = Bucket;
+
+	const SignificanceBuckets::FBucket& settings = SignificanceBuckets::Get(Bucket);
+
+	Entry.Perception->SetRateScale(settings.PerceptionRateScale);
+
+	if (const APawn* pawn = Cast<APawn>(Entry.Ghost.Get()))
+	{
+		if (AAIController* controller = Cast<AAIController>(pawn->GetController()))
+		{
+			controller->SetActorTickInterval(settings.TickInterval);
+
+			if (UBrainComponent* brain = controller->GetBrainComponent())
+				brain->SetComponentTickInterval(settings.TickInterval);
+		}
+	}
+
+	USkeletalMeshComponent* mesh = Entry.Mesh.Get();
+	if (!mesh)
+		return;
+
+	mesh->SetComponentTickInterval(settings.TickInterval);
+	mesh->VisibilityBasedAnimTickOption = settings.bOnlyTickWhenRendered
+		? EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered
+		: static_cast<EVisibilityBasedAnimTickOption>(Entry.AuthoredTickOption);
+
+	// The LOD map makes URO use the bucket's skip whatever the screen size
+	if (FAnimUpdateRateParameters* uro = mesh->AnimUpdateRateParams)
+	{
+		uro->bShouldUseLodMap = true;
+		uro->LODToFrameSkipMap.Reset();
+
+		const int32 numLODs = FMath::Max(mesh->GetNumLODs(), 1);
+		for (int32 lod = 0; lod < numLODs; ++lod)
+			uro->LODToFrameSkipMap.Add(lod, settings.AnimFrameSkip);
+	}
+}
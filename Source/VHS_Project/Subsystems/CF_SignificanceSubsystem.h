@@ -0,0 +1,94 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "CF_SignificanceSubsystem.generated.h"
+
+// # Engine Forwards
+class USkeletalMeshComponent;
+
+// # Project Forwards
+class UCF_GhostPerceptionComponent;
+
+UENUM(BlueprintType)
+enum class ESignificance : uint8
+{
+	High,
+	Medium,
+	Low,
+	Dormant,
+	MAX UMETA(Hidden)
+};
+
+/**
+ * Level of detail for the ghosts' AI and animation. Every few frames each ghost is scored by distance to the camera,
+ * whether it was rendered and its EGhostState, and its bucket sets the behaviour tree and controller tick interval,
+ * the perception rate, the animation frame skip, the skeletal mesh tick and whether ABP_Ghost evaluates its AimOffset.
+ * A ghost that's chasing the player is always High.
+ */
+UCLASS(Config = Game)
+class VHS_PROJECT_API UCF_SignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	void Register(UCF_GhostPerceptionComponent* Perception);
+
+	void Unregister(UCF_GhostPerceptionComponent* Perception);
+
+	UFUNCTION(BlueprintPure, Category = "Significance")
+	ESignificance GetSignificance(const AActor* Ghost) const;
+
+	/** Read by ABP_Ghost, the AimOffset is bypassed when false */
+	UFUNCTION(BlueprintPure, Category = "Significance")
+	bool ShouldEvaluateAimOffset(const AActor* Ghost) const;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Seconds between two scorings */
+	UPROPERTY(Config) float ScoreInterval = .25f;
+
+	/** Distance in cm at which the distance score reaches 0 */
+	UPROPERTY(Config) float MaxDistance = 6000.f;
+
+	/** Score multiplier for ghosts that weren't rendered recently */
+	UPROPERTY(Config) float HiddenScale = .4f;
+
+	/** Score margin a ghost has to drop past a bucket threshold before it's demoted */
+	UPROPERTY(Config) float Hysteresis = .05f;
+
+	struct FSignificanceEntry
+	{
+		TWeakObjectPtr<UCF_GhostPerceptionComponent> Perception;
+		TWeakObjectPtr<AActor> Ghost;
+		TWeakObjectPtr<USkeletalMeshComponent> Mesh;
+
+		/** Restored on the buckets that don't override it */
+		uint8 AuthoredTickOption = 0;
+
+		ESignificance Bucket = ESignificance::MAX;
+		float Score = 0.f;
+	};
+
+	TArray<FSignificanceEntry> Entries;
+
+	float TimeToScore = 0.f;
+
+	// -------------------------------------------------------------------------
+
+	int32 FindEntry(const AActor* Ghost) const;
+
+	float ComputeScore(const FSignificanceEntry& Entry, const FVector& ViewLocation) const;
+
+	ESignificance ComputeBucket(const FSignificanceEntry& Entry, const float Score) const;
+
+	void ApplyBucket(FSignificanceEntry& Entry, const ESignificance Bucket);
+};
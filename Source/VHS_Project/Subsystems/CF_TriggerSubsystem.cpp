@@ -0,0 +1,210 @@
+#include "CF_TriggerSubsystem.h"
+
+// # Engine Includes
+#include "Engine/World.h"
+
+// # Project Includes
+#include "VHS_Project.h"
+#include "Components/CF_TriggerComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Trigger Tick"), STAT_VHS_TriggerTick, STATGROUP_VHS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Triggers Registered"), STAT_VHS_TriggersRegistered, STATGROUP_VHS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Trigger Tests"), STAT_VHS_TriggerTests, STATGROUP_VHS);
+
+void UCF_TriggerSubsystem::RegisterTrigger(UCF_TriggerComponent* Trigger)
+{
+	if (!Trigger || TriggerLookup.Contains(Trigger))
+		return;
+
+	const uint8 actorMask = (Trigger->bTriggeredByPlayer ? 1 << static_cast<uint8>(ETriggerActor::Player) : 0)
+		| (Trigger->bTriggeredByGhosts ? 1 << static_cast<uint8>(ETriggerActor::Ghost) : 0);
+	if (actorMask == 0)
+		return;
+
+	const int32 idx = FreeTriggers.Num() > 0 ? FreeTriggers.Pop(false) : Triggers.AddDefaulted();
+
+	FTriggerEntry& entry = Triggers[idx];
+	entry.Component = Trigger;
+	entry.Key = Trigger;
+	entry.Transform = Trigger->GetComponentTransform();
+	entry.Extent = Trigger->GetScaledBoxExtent();
+	entry.Transform.SetScale3D(FVector::OneVector);
+	entry.ActorMask = actorMask;
+	entry.bSingleUse = Trigger->bSingleUse;
+	entry.Cells.Reset();
+
+	TriggerLookup.Add(Trigger, idx);
+
+	const FBox bounds = FBox::BuildAABB(FVector::ZeroVector, entry.Extent).TransformBy(entry.Transform).ExpandBy(MaxActorRadius);
+	const FIntPoint minCell = GetCell(bounds.Min);
+	const FIntPoint maxCell = GetCell(bounds.Max);
+
+	for (int32 x = minCell.X; x <= maxCell.X; ++x)
+	{
+		for (int32 y = minCell.Y; y <= maxCell.Y; ++y)
+		{
+			Cells.FindOrAdd(FIntPoint(x, y)).Add(idx);
+			entry.Cells.Add(FIntPoint(x, y));
+		}
+	}
+
+	INC_DWORD_STAT(STAT_VHS_TriggersRegistered);
+}
+
+void UCF_TriggerSubsystem::UnregisterTrigger(UCF_TriggerComponent* Trigger)
+{
+	if (const int32* idx = TriggerLookup.Find(Trigger))
+		RemoveTrigger(*idx);
+}
+
+void UCF_TriggerSubsystem::RegisterActor(AActor* Actor, const ETriggerActor Kind, const float Radius)
+{
+	if (!Actor || Actors.ContainsByPredicate([Actor](const FTrackedActor& tracked) { return tracked.Actor.Get() == Actor; }))
+		return;
+
+	if (Radius > MaxActorRadius)
+		UE_LOG(LogVHS, Warning, TEXT("Triggers: %s radius %.0f is over %.0f, triggers past its cell can be missed"), *Actor->GetName(), Radius, MaxActorRadius);
+
+	FTrackedActor& tracked = Actors.AddDefaulted_GetRef();
+	tracked.Actor = Actor;
+	tracked.Kind = Kind;
+	tracked.Radius = FMath::Min(Radius, MaxActorRadius);
+}
+
+void UCF_TriggerSubsystem::UnregisterActor(AActor* Actor)
+{
+	// Leaving the world isn't an exit, despawn triggers destroy the ghost from their enter event
+	Actors.RemoveAllSwap([Actor](const FTrackedActor& tracked) { return tracked.Actor.Get() == Actor; });
+}
+
+void UCF_TriggerSubsystem::Tick(float DeltaTime)
+{
+	VHS_SCOPE(TriggerTick);
+
+	Super::Tick(DeltaTime);
+
+	Events.Reset();
+	uint32 numTests = 0;
+
+	for (int32 a = Actors.Num() - 1; a >= 0; --a)
+	{
+		FTrackedActor& tracked = Actors[a];
+
+		const AActor* actor = tracked.Actor.Get();
+		if (!actor)
+		{
+			Actors.RemoveAtSwap(a);
+			continue;
+		}
+
+		const FVector location = actor->GetActorLocation();
+		const uint8 actorBit = 1 << static_cast<uint8>(tracked.Kind);
+
+		TArray<int32, TInlineAllocator<4>> inside;
+		if (const TArray<int32>* cell = Cells.Find(GetCell(location)))
+		{
+			for (const int32 idx : *cell)
+			{
+				const FTriggerEntry& trigger = Triggers[idx];
+				if (!(trigger.ActorMask & actorBit))
+					continue;
+
+				++numTests;
+				if (IsInside(trigger, location, tracked.Radius))
+					inside.Add(idx);
+			}
+		}
+
+		for (const int32 idx : inside)
+		{
+			if (!tracked.Inside.Contains(idx))
+				Events.Add({ idx, tracked.Actor, true });
+		}
+
+		for (const int32 idx : tracked.Inside)
+		{
+			if (!inside.Contains(idx))
+				Events.Add({ idx, tracked.Actor, false });
+		}
+
+		tracked.Inside = MoveTemp(inside);
+	}
+
+	for (const FTriggerEvent& event : Events)
+	{
+		// An earlier handler may have removed the trigger or destroyed the actor
+		FTriggerEntry& trigger = Triggers[event.Trigger];
+		UCF_TriggerComponent* component = trigger.Component.Get();
+		AActor* actor = event.Actor.Get();
+		if (!component || !actor)
+			continue;
+
+		if (!event.bEnter)
+		{
+			component->OnActorExit.Broadcast(component, actor);
+			continue;
+		}
+
+		if (trigger.bSingleUse)
+			RemoveTrigger(event.Trigger);
+
+		component->OnActorEnter.Broadcast(component, actor);
+	}
+
+	SET_DWORD_STAT(STAT_VHS_TriggerTests, numTests);
+}
+
+TStatId UCF_TriggerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCF_TriggerSubsystem, STATGROUP_Tickables);
+}
+
+bool UCF_TriggerSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+FIntPoint UCF_TriggerSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+void UCF_TriggerSubsystem::RemoveTrigger(const int32 Idx)
+{
+	FTriggerEntry& entry = Triggers[Idx];
+
+	for (const FIntPoint& cellKey : entry.Cells)
+	{
+		if (TArray<int32>* cell = Cells.Find(cellKey))
+		{
+			cell->RemoveSingleSwap(Idx, false);
+			if (cell->IsEmpty())
+				Cells.Remove(cellKey);
+		}
+	}
+
+	// Removed triggers never fire an exit
+	for (FTrackedActor& tracked : Actors)
+		tracked.Inside.RemoveSingleSwap(Idx, false);
+
+	for (FTriggerEvent& event : Events)
+	{
+		if (event.Trigger == Idx)
+			event.Actor = nullptr;
+	}
+
+	TriggerLookup.Remove(entry.Key);
+	entry = FTriggerEntry();
+	FreeTriggers.Add(Idx);
+
+	DEC_DWORD_STAT(STAT_VHS_TriggersRegistered);
+}
+
+bool UCF_TriggerSubsystem::IsInside(const FTriggerEntry& Trigger, const FVector& Location, const float Radius) const
+{
+	// Sphere against the oriented box, in the unscaled space of the trigger
+	const FVector local = Trigger.Transform.InverseTransformPositionNoScale(Location);
+	const FVector closest = local.BoundToBox(-Trigger.Extent, Trigger.Extent);
+
+	return FVector::DistSquared(local, closest) <= FMath::Square(Radius);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "CF_TriggerSubsystem.generated.h"
+
+// # Project Forwards
+class UCF_TriggerComponent;
+
+enum class ETriggerActor : uint8
+{
+	Player,
+	Ghost
+};
+
+/**
+ * Static triggers in a uniform grid on the ground plane. Each trigger is inserted into every cell its bounds cover,
+ * grown by the largest actor radius, so once per frame an actor only tests the triggers of the one cell it stands in.
+ * Enter and exit events are collected during the pass and fired after it, handlers are free to spawn or destroy.
+ */
+UCLASS()
+class VHS_PROJECT_API UCF_TriggerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	void RegisterTrigger(UCF_TriggerComponent* Trigger);
+
+	void UnregisterTrigger(UCF_TriggerComponent* Trigger);
+
+	/** Actors are tested as a sphere of Radius around their location */
+	void RegisterActor(AActor* Actor, const ETriggerActor Kind, const float Radius);
+
+	void UnregisterActor(AActor* Actor);
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	float CellSize = 1000.f;
+
+	/** Triggers are grown by this when hashed, actors with a larger radius can miss a trigger in the next cell */
+	float MaxActorRadius = 100.f;
+
+	struct FTriggerEntry
+	{
+		TWeakObjectPtr<UCF_TriggerComponent> Component;
+		TObjectKey<UCF_TriggerComponent> Key;
+
+		/** Without scale, the extent is scaled instead */
+		FTransform Transform;
+		FVector Extent = FVector::ZeroVector;
+
+		/** Bit per ETriggerActor */
+		uint8 ActorMask = 0;
+		bool bSingleUse = false;
+
+		TArray<FIntPoint, TInlineAllocator<4>> Cells;
+	};
+
+	struct FTrackedActor
+	{
+		TWeakObjectPtr<AActor> Actor;
+		ETriggerActor Kind = ETriggerActor::Player;
+		float Radius = 0.f;
+
+		/** Triggers the actor was inside last frame */
+		TArray<int32, TInlineAllocator<4>> Inside;
+	};
+
+	struct FTriggerEvent
+	{
+		int32 Trigger;
+		TWeakObjectPtr<AActor> Actor;
+		bool bEnter;
+	};
+
+	/** Sparse, cells hold indices and removed triggers leave a free slot */
+	TArray<FTriggerEntry> Triggers;
+	TArray<int32> FreeTriggers;
+	TMap<TObjectKey<UCF_TriggerComponent>, int32> TriggerLookup;
+	TMap<FIntPoint, TArray<int32>> Cells;
+
+	TArray<FTrackedActor> Actors;
+
+	/** Kept between frames, no allocation once it has grown */
+	TArray<FTriggerEvent> Events;
+
+	// -------------------------------------------------------------------------
+
+	FIntPoint GetCell(const FVector& Location) const;
+
+	void RemoveTrigger(const int32 Idx);
+
+	bool IsInside(const FTriggerEntry& Trigger, const FVector& Location, const float Radius) const;
+};
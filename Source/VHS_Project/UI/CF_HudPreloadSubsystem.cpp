@@ -0,0 +1,104 @@
+#include "CF_HudPreloadSubsystem.h"
+
+// # Engine Includes
+#include "Blueprint/UserWidget.h"
+
+// # Project Includes
+#include "VHS_Project.h"
+
+DECLARE_MEMORY_STAT(TEXT("HUD Widget Assets"), STAT_VHS_HudAssetMemory, STATGROUP_VHS);
+
+DECLARE_CYCLE_STAT(TEXT("HUD Widget Loaded"), STAT_VHS_HudWidgetLoaded, STATGROUP_VHS);
+
+void UCF_HudPreloadSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	for (const auto& widget : Widgets)
+	{
+		if (widget.WidgetClass.IsValid())
+			RequestLoad(widget.WidgetClass, widget.Dependencies);
+	}
+}
+
+void UCF_HudPreloadSubsystem::Deinitialize()
+{
+	for (auto& load : Loads)
+	{
+		if (load.Value.Handle.IsValid())
+			load.Value.Handle->CancelHandle();
+
+		DEC_MEMORY_STAT_BY(STAT_VHS_HudAssetMemory, load.Value.ResidentBytes);
+	}
+
+	Loads.Empty();
+
+	Super::Deinitialize();
+}
+
+void UCF_HudPreloadSubsystem::RequestWidgetClass(const TSoftClassPtr<UUserWidget>& WidgetClass, FOnHudWidgetClassLoaded Callback)
+{
+	if (WidgetClass.IsNull())
+		return;
+
+	FHudWidgetLoad& load = RequestLoad(WidgetClass.ToSoftObjectPath(), {});
+
+	if (load.LoadLatency >= 0.f)
+	{
+		Callback.ExecuteIfBound(WidgetClass.Get());
+		return;
+	}
+
+	load.Callbacks.Add(MoveTemp(Callback));
+}
+
+float UCF_HudPreloadSubsystem::GetLoadLatency(const TSoftClassPtr<UUserWidget>& WidgetClass) const
+{
+	const FHudWidgetLoad* load = Loads.Find(WidgetClass.ToSoftObjectPath());
+	return load ? load->LoadLatency : -1.f;
+}
+
+UCF_HudPreloadSubsystem::FHudWidgetLoad& UCF_HudPreloadSubsystem::RequestLoad(const FSoftObjectPath& WidgetClass, const TArray<FSoftObjectPath>& Dependencies)
+{
+	if (FHudWidgetLoad* found = Loads.Find(WidgetClass))
+		return *found;
+
+	FHudWidgetLoad& load = Loads.Add(WidgetClass);
+	load.RequestTime = FPlatformTime::Seconds();
+
+	load.Paths = Dependencies;
+	load.Paths.Add(WidgetClass);
+
+	// An already resident batch calls back from inside RequestAsyncLoad, before the handle is stored
+	load.Handle = StreamableManager.RequestAsyncLoad(load.Paths, FStreamableDelegate::CreateUObject(this, &UCF_HudPreloadSubsystem::HandleWidgetLoaded, WidgetClass), FStreamableManager::AsyncLoadHighPriority);
+
+	return Loads.FindChecked(WidgetClass);
+}
+
+void UCF_HudPreloadSubsystem::HandleWidgetLoaded(FSoftObjectPath WidgetClass)
+{
+	VHS_SCOPE(HudWidgetLoaded);
+
+	FHudWidgetLoad* load = Loads.Find(WidgetClass);
+	if (!load)
+		return;
+
+	load->LoadLatency = static_cast<float>(FPlatformTime::Seconds() - load->RequestTime);
+
+	for (const auto& path : load->Paths)
+	{
+		if (const UObject* asset = path.ResolveObject())
+			load->ResidentBytes += asset->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+	}
+
+	INC_MEMORY_STAT_BY(STAT_VHS_HudAssetMemory, load->ResidentBytes);
+	UE_LOG(LogVHS, Log, TEXT("HUD widget %s resident in %.3fs"), *WidgetClass.ToString(), load->LoadLatency);
+
+	UClass* widgetClass = Cast<UClass>(WidgetClass.ResolveObject());
+	if (!widgetClass)
+		UE_LOG(LogVHS, Warning, TEXT("HUD widget %s failed to load"), *WidgetClass.ToString());
+
+	TArray<FOnHudWidgetClassLoaded> callbacks = MoveTemp(load->Callbacks);
+	for (auto& callback : callbacks)
+		callback.ExecuteIfBound(widgetClass);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Engine/StreamableManager.h"
+
+#include "CF_HudPreloadSubsystem.generated.h"
+
+// # Engine Forwards
+class UUserWidget;
+
+DECLARE_DELEGATE_OneParam(FOnHudWidgetClassLoaded, TSubclassOf<UUserWidget>)
+
+USTRUCT()
+struct FST_HudWidgetPreload
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Config) FSoftClassPath WidgetClass;
+
+	/** Assets the widget pulls in at construction (media, materials, fonts), streamed in the same batch */
+	UPROPERTY(Config) TArray<FSoftObjectPath> Dependencies;
+};
+
+/**
+ * Streams the HUD widget classes and their dependencies as soon as the game instance starts, i.e. while the
+ * first map is still loading. The player asks for the classes it needs and is called back once they're resident.
+ */
+UCLASS(Config = Game)
+class VHS_PROJECT_API UCF_HudPreloadSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	/** Calls back right away if the class is already resident, classes missing from the config are loaded on demand */
+	void RequestWidgetClass(const TSoftClassPtr<UUserWidget>& WidgetClass, FOnHudWidgetClassLoaded Callback);
+
+	/** Seconds between the request and the widget batch becoming resident, negative if it isn't yet */
+	float GetLoadLatency(const TSoftClassPtr<UUserWidget>& WidgetClass) const;
+
+protected:
+
+	UPROPERTY(Config) TArray<FST_HudWidgetPreload> Widgets;
+
+	struct FHudWidgetLoad
+	{
+		TSharedPtr<FStreamableHandle> Handle;
+		TArray<FOnHudWidgetClassLoaded> Callbacks;
+		TArray<FSoftObjectPath> Paths;
+
+		double RequestTime = 0.0;
+		float LoadLatency = -1.f;
+		int64 ResidentBytes = 0;
+	};
+
+	FStreamableManager StreamableManager;
+
+	TMap<FSoftObjectPath, FHudWidgetLoad> Loads;
+
+	// -------------------------------------------------------------------------
+
+	FHudWidgetLoad& RequestLoad(const FSoftObjectPath& WidgetClass, const TArray<FSoftObjectPath>& Dependencies);
+
+	void HandleWidgetLoaded(FSoftObjectPath WidgetClass);
+};
@@ -0,0 +1,35 @@
+#include "CF_HudTextCache.h"
+
+// # Engine Includes
+#include "Components/TextBlock.h"
+
+const FText& FCF_HudTextCache::GetClock(const int32 Hours, const int32 Minutes)
+{
+	const int32 key = GetClockKey(Hours, Minutes);
+	if (const FText* text = ClockTexts.Find(key))
+		return *text;
+
+	const TCHAR* period = Hours < 12 ? TEXT("AM") : TEXT("PM");
+	return ClockTexts.Add(key, FText::FromString(FString::Printf(TEXT("%s %02d:%02d"), period, Hours, Minutes)));
+}
+
+const FText& FCF_HudTextCache::GetZoom(const int32 ZoomLevel)
+{
+	if (const FText* text = ZoomTexts.Find(ZoomLevel))
+		return *text;
+
+	const float zoom = FMath::Clamp(ZoomLevel, 1, 4) / 2.f;
+	return ZoomTexts.Add(ZoomLevel, FText::FromString(FString::Printf(TEXT("X %f"), zoom)));
+}
+
+bool FCF_HudTextSlot::Show(const int32 Key, const FText& inText)
+{
+	UTextBlock* text = Text.Get();
+	if (!text || Key == ShownKey)
+		return false;
+
+	// An unchanged key skips SetText, so an idle readout never invalidates the cached overlay
+	ShownKey = Key;
+	text->SetText(inText);
+	return true;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// # Engine Forwards
+class UTextBlock;
+
+/**
+ * Interns the handful of strings the VHS HUD can show. Each text is formatted once, the first time its value is
+ * displayed, and handed out by reference afterwards.
+ */
+class VHS_PROJECT_API FCF_HudTextCache
+{
+public:
+
+	const FText& GetClock(const int32 Hours, const int32 Minutes);
+
+	const FText& GetZoom(const int32 ZoomLevel);
+
+	static int32 GetClockKey(const int32 Hours, const int32 Minutes) { return Hours * 60 + Minutes; }
+
+private:
+
+	TMap<int32, FText> ClockTexts;
+	TMap<int32, FText> ZoomTexts;
+};
+
+/** A text block that's only touched when the value it displays changes */
+struct VHS_PROJECT_API FCF_HudTextSlot
+{
+	TWeakObjectPtr<UTextBlock> Text;
+	int32 ShownKey = INDEX_NONE;
+
+	/** Returns true if the text block was updated */
+	bool Show(const int32 Key, const FText& inText);
+
+	/** Same as Show, the text is only resolved if the key changed */
+	template <typename FuncType>
+	bool ShowLazy(const int32 Key, FuncType&& GetText)
+	{
+		return Key != ShownKey && Show(Key, GetText());
+	}
+};
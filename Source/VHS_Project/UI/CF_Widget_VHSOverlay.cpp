@@ -2,17 +2,52 @@
 
 #include "MediaPlayer.h"
 #include "MediaSource.h"
+#include "MediaTexture.h"
 #include "Kismet/GameplayStatics.h"
 #include "Kismet/KismetMaterialLibrary.h"
+#include "Materials/MaterialInstanceDynamic.h"
 #include "TimerManager.h"
 
+#include "Blueprint/WidgetTree.h"
 #include "Components/Image.h"
+#include "Components/InvalidationBox.h"
 #include "Components/TextBlock.h"
+#include "GameFramework/Pawn.h"
+
+#include "VHS_Project.h"
+#include "Components/CF_VHSEffectsComponent.h"
+#include "Subsystems/CF_RandomSubsystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("HUD Randomize Overlay"), STAT_VHS_RandomizeOverlay, STATGROUP_VHS);
+DECLARE_CYCLE_STAT(TEXT("HUD Overlay Preroll"), STAT_VHS_OverlayPreroll, STATGROUP_VHS);
+DECLARE_CYCLE_STAT(TEXT("HUD Swap Overlay"), STAT_VHS_SwapOverlay, STATGROUP_VHS);
+DECLARE_CYCLE_STAT(TEXT("HUD Update Time"), STAT_VHS_UpdateTime, STATGROUP_VHS);
+DECLARE_CYCLE_STAT(TEXT("HUD Update Zoom"), STAT_VHS_UpdateZoom, STATGROUP_VHS);
+
+void UCF_Widget_VHSOverlay::NativeOnInitialized()
+{
+	Super::NativeOnInitialized();
+
+	// Nothing in the overlay is volatile, the media and battery images only change material and texture contents.
+	// Cached in an invalidation box, a frame where no text or visibility changed repaints nothing, and SetText on
+	// the clock or zoom only invalidates that text block. Runs before the Slate widgets are built.
+	UWidget* root = WidgetTree ? WidgetTree->RootWidget : nullptr;
+	if (root && !root->IsA<UInvalidationBox>())
+	{
+		auto* box = WidgetTree->ConstructWidget<UInvalidationBox>(UInvalidationBox::StaticClass(), TEXT("OverlayInvalidation"));
+		box->SetCanCache(true);
+		WidgetTree->RootWidget = box;
+		box->SetContent(root);
+	}
+}
 
 void UCF_Widget_VHSOverlay::NativeConstruct()
 {
 	Super::NativeConstruct();
 
+	TimeSlot.Text = TXT_Time;
+	ZoomSlot.Text = TXT_Zoom;
+
 	UpdateTime();
 
 	auto batteryBrush = Battery->GetBrush();
@@ -21,6 +56,12 @@ void UCF_Widget_VHSOverlay::NativeConstruct()
 
 	Battery->SetBrushFromMaterial(Mat_Battery);
 
+	if (APawn* pawn = GetOwningPlayerPawn())
+		Effects = pawn->FindComponentByClass<UCF_VHSEffectsComponent>();
+
+	if (Effects.IsValid())
+		Effects->BindMaterial(Mat_Battery);
+
 	if(auto* world = GetWorld())
 	{
 		FTimerHandle TH_UpdateTime;
@@ -30,15 +71,35 @@ void UCF_Widget_VHSOverlay::NativeConstruct()
 		world->GetTimerManager().SetTimer(TH_UpdateBattery, this, &UCF_Widget_VHSOverlay::UpdateBattery, TimeToDie * 60.f / 4.f, true);
 	}
 
+	OverlayBag.Reset(Overlays);
+	OverlayBag.SetStream(UCF_RandomSubsystem::MakeStreamFor(this, TEXT("OverlayBag")));
+	OverlayTimerStream = UCF_RandomSubsystem::MakeStreamFor(this, TEXT("OverlayTimer"));
+
+	SetupOverlayPlayers();
 	RandomizeOverlay();
 }
 
-FString UCF_Widget_VHSOverlay::FixTimeString(const FString& inTime) const
+void UCF_Widget_VHSOverlay::NativeDestruct()
 {
-	return FString::Printf(TEXT("%02d"), *inTime);
+	if (auto* world = GetWorld())
+	{
+		world->GetTimerManager().ClearTimer(TH_Overlay);
+		world->GetTimerManager().ClearTimer(TH_Preroll);
+	}
+
+	for (auto* player : OverlayPlayers)
+	{
+		if (player)
+			player->Close();
+	}
+
+	if (Effects.IsValid())
+		Effects->UnbindMaterial(Mat_Battery);
+
+	Super::NativeDestruct();
 }
 
-FText UCF_Widget_VHSOverlay::CalculateTime() const
+void UCF_Widget_VHSOverlay::CalculateTime(int32& OutHours, int32& OutMinutes) const
 {
 	const float realTime = UGameplayStatics::GetRealTimeSeconds(this) / 3600.f;
 	const int32 truncTime = FMath::TruncToInt32(realTime);
@@ -47,64 +108,139 @@ FText UCF_Widget_VHSOverlay::CalculateTime() const
 
 	int32 totalMinutes = StartMinute + (realTime - (totalHours - (totalHours % 24) + truncTime) * 60);
 
-	const int32 hours = totalMinutes / 60 + (totalHours % 24) % 24;
-	const int32 mins = totalMinutes % 60;
+	OutHours = totalMinutes / 60 + (totalHours % 24) % 24;
+	OutMinutes = totalMinutes % 60;
+}
+
+void UCF_Widget_VHSOverlay::SetupOverlayPlayers()
+{
+	for (int32 i = 0; i < 2; ++i)
+	{
+		auto* player = NewObject<UMediaPlayer>(this);
+		player->PlayOnOpen = true;
+		player->SetLooping(true);
+
+		auto* texture = NewObject<UMediaTexture>(this);
+		texture->SetMediaPlayer(player);
+		texture->UpdateResource();
+
+		OverlayPlayers[i] = player;
+		OverlayTextures[i] = texture;
+
+		if (UImage* image = GetOverlayImage(i))
+		{
+			// Keeps the authored brush material and its blending, only the texture it samples changes
+			if (auto* mat = Cast<UMaterialInterface>(image->GetBrush().GetResourceObject()))
+			{
+				Mat_Overlays[i] = UKismetMaterialLibrary::CreateDynamicMaterialInstance(this, mat);
+				Mat_Overlays[i]->SetTextureParameterValue(OverlayTextureParameter, texture);
+				image->SetBrushFromMaterial(Mat_Overlays[i]);
+			}
+			else
+			{
+				UE_LOG(LogVHS, Warning, TEXT("%s has no brush material, the overlay is drawn without blending"), *image->GetName());
+				image->SetBrushResourceObject(texture);
+			}
+
+			image->SetVisibility(ESlateVisibility::Hidden);
+		}
+	}
+}
+
+void UCF_Widget_VHSOverlay::RandomizeOverlay()
+{
+	VHS_SCOPE(RandomizeOverlay);
 
-	const FString period = hours < 12 ? "AM" : "PM";
+	auto* world = GetWorld();
+	UMediaPlayer* back = OverlayPlayers[GetBackOverlay()];
+	UMediaSource* overlay = OverlayBag.IsEmpty() ? nullptr : OverlayBag.Draw();
 
-	return FText::FromString(FString::Printf(TEXT("%s %02d:%02d"), *period, hours, mins));
+	// Opening on the visible player stalls it until the decoder is ready, the back one is hidden meanwhile
+	if (!world || !back || !overlay || !back->OpenSource(overlay))
+	{
+		StartRandomOverlayTimer();
+		return;
+	}
+
+	PrerollStartTime = world->GetRealTimeSeconds();
+	world->GetTimerManager().SetTimer(TH_Preroll, this, &UCF_Widget_VHSOverlay::CheckPreroll, 1.f / 60.f, true);
 }
 
-UMediaSource* UCF_Widget_VHSOverlay::GetRandomOverlay()
+void UCF_Widget_VHSOverlay::CheckPreroll()
 {
-	int32 idx = FMath::RandRange(0, Overlays.Num() - 1);
-	const auto& overlay = Overlays[idx];
+	VHS_SCOPE(OverlayPreroll);
+
+	auto* world = GetWorld();
+	UMediaPlayer* back = OverlayPlayers[GetBackOverlay()];
+	if (!world || !back)
+		return;
 
-	if (overlay == LastOverlay)
-		return GetRandomOverlay();
+	if (back->IsPlaying() && back->GetDisplayTime() > FTimespan::Zero())
+	{
+		world->GetTimerManager().ClearTimer(TH_Preroll);
+		SwapOverlay();
+		StartRandomOverlayTimer();
+		return;
+	}
 
-	LastOverlay = overlay;
-	return overlay;
+	// Keep the current overlay rather than waiting on a source that won't open
+	if (back->HasError() || world->GetRealTimeSeconds() - PrerollStartTime > PrerollTimeout)
+	{
+		world->GetTimerManager().ClearTimer(TH_Preroll);
+		back->Close();
+		StartRandomOverlayTimer();
+	}
 }
 
-void UCF_Widget_VHSOverlay::RandomizeOverlay()
+void UCF_Widget_VHSOverlay::SwapOverlay()
 {
-	MP_Overlay->OpenSource(GetRandomOverlay());
+	VHS_SCOPE(SwapOverlay);
 
-	StartRandomOverlayTimer();
+	const int32 front = GetBackOverlay();
+
+	if (UImage* image = GetOverlayImage(front))
+		image->SetVisibility(ESlateVisibility::HitTestInvisible);
+
+	if (FrontOverlay != INDEX_NONE)
+	{
+		if (UImage* image = GetOverlayImage(FrontOverlay))
+			image->SetVisibility(ESlateVisibility::Hidden);
+
+		if (UMediaPlayer* player = OverlayPlayers[FrontOverlay])
+			player->Close();
+	}
+
+	FrontOverlay = front;
 }
 
 void UCF_Widget_VHSOverlay::StartRandomOverlayTimer()
 {
 	if (auto* world = GetWorld())
-	{
-		FTimerHandle TH_Overlay;
-		world->GetTimerManager().SetTimer(TH_Overlay, this, &UCF_Widget_VHSOverlay::RandomizeOverlay, FMath::RandRange(5.f, 20.f), false);
-	}
+		world->GetTimerManager().SetTimer(TH_Overlay, this, &UCF_Widget_VHSOverlay::RandomizeOverlay, OverlayTimerStream.FRandRange(5.f, 20.f), false);
 }
 
 void UCF_Widget_VHSOverlay::UpdateTime()
 {
-	TXT_Time->SetText(CalculateTime());
+	VHS_SCOPE(UpdateTime);
+
+	int32 hours = 0;
+	int32 mins = 0;
+	CalculateTime(hours, mins);
+
+	TimeSlot.ShowLazy(FCF_HudTextCache::GetClockKey(hours, mins), [this, hours, mins]() -> const FText& { return TextCache.GetClock(hours, mins); });
 }
 
 void UCF_Widget_VHSOverlay::UpdateBattery()
 {
 	MissingBattery += 0.33f;
 
-	const float twoThirds = 1.f / 1.5f;
-	Mat_Battery->SetScalarParameterValue(FName("MissingBattery"), FMath::Min(MissingBattery, twoThirds));
-
-	if (MissingBattery < twoThirds)
-		return;
-
-	Mat_Battery->SetScalarParameterValue(FName("BatteryLow"), 1.f);
+	if (Effects.IsValid())
+		Effects->SetMissingBattery(MissingBattery);
 }
 
-void UCF_Widget_VHSOverlay::UpdateZoom(const float inZoom)
+void UCF_Widget_VHSOverlay::UpdateZoom(const int32 ZoomLevel)
 {
-	float zoom = FMath::Clamp(inZoom, 1.f, 4.f) / 2.f;
-	const FString zoomStr = FString::Printf(TEXT("X %f"), zoom);
+	VHS_SCOPE(UpdateZoom);
 
-	TXT_Zoom->SetText(FText::FromString(zoomStr));
+	ZoomSlot.ShowLazy(ZoomLevel, [this, ZoomLevel]() -> const FText& { return TextCache.GetZoom(ZoomLevel); });
 }
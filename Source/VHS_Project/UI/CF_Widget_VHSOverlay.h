@@ -2,12 +2,18 @@
 
 #include "CoreMinimal.h"
 #include "Blueprint/UserWidget.h"
+
+#include "UI/CF_HudTextCache.h"
+#include "Utils/CFShuffleBag.h"
+
 #include "CF_Widget_VHSOverlay.generated.h"
 
 class UMediaPlayer;
 class UMediaSource;
+class UMediaTexture;
 class UImage;
 class UTextBlock;
+class UCF_VHSEffectsComponent;
 
 UCLASS()
 class VHS_PROJECT_API UCF_Widget_VHSOverlay : public UUserWidget
@@ -16,12 +22,16 @@ class VHS_PROJECT_API UCF_Widget_VHSOverlay : public UUserWidget
 
 public:
 
-	void UpdateZoom(const float inZoom);
+	void UpdateZoom(const int32 ZoomLevel);
 
 protected:
 
+	virtual void NativeOnInitialized() override;
+
 	virtual void NativeConstruct() override;
 
+	virtual void NativeDestruct() override;
+
 	//
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (BindWidget)) UTextBlock* TXT_Time;
@@ -42,26 +52,61 @@ protected:
 	/** Time in minutes */
 	float TimeToDie = 30.f;
 
-	UMediaPlayer* MP_Overlay = nullptr;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "CustomProperties | Overlay")
+	TArray<UMediaSource*> Overlays = {};
 
-	UMediaSource* LastOverlay = nullptr;
+	/** Seconds the back player gets to decode its first frame before the switch is dropped */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "CustomProperties | Overlay")
+	float PrerollTimeout = 3.f;
 
-	TArray<UMediaSource*> Overlays = {};
+	/** Texture parameter of the overlay images' brush material (M_Overlay) that samples the media texture */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "CustomProperties | Overlay")
+	FName OverlayTextureParameter = "MediaTexture";
+
+	TCF_ShuffleBag<UMediaSource*> OverlayBag;
+
+	/** Delay between overlay switches, the bag has its own stream */
+	FCF_RandomStream OverlayTimerStream;
+
+	/** Ping-pong pair, VHS_Overlay_One shows player 0 and VHS_Overlay_Two player 1 */
+	UPROPERTY() UMediaPlayer* OverlayPlayers[2] = {};
+	UPROPERTY() UMediaTexture* OverlayTextures[2] = {};
+	UPROPERTY() UMaterialInstanceDynamic* Mat_Overlays[2] = {};
+
+	int32 FrontOverlay = INDEX_NONE;
+	double PrerollStartTime = 0.0;
+
+	FTimerHandle TH_Overlay;
+	FTimerHandle TH_Preroll;
 
 private:
 
-	UMaterialInstanceDynamic* Mat_Battery = nullptr;
+	UPROPERTY() UMaterialInstanceDynamic* Mat_Battery = nullptr;
+
+	/** Owns the battery parameters, Mat_Battery is bound to it */
+	TWeakObjectPtr<UCF_VHSEffectsComponent> Effects;
+
+	FCF_HudTextCache TextCache;
+	FCF_HudTextSlot TimeSlot;
+	FCF_HudTextSlot ZoomSlot;
 
 	//
 
-	FString FixTimeString(const FString& inTime) const;
+	void CalculateTime(int32& OutHours, int32& OutMinutes) const;
+
+	void SetupOverlayPlayers();
 
-	FText CalculateTime() const;
+	UImage* GetOverlayImage(const int32 Idx) const { return Idx == 0 ? VHS_Overlay_One : VHS_Overlay_Two; }
 
-	UMediaSource* GetRandomOverlay();
+	int32 GetBackOverlay() const { return FrontOverlay == 0 ? 1 : 0; }
 
+	/** Opens the next overlay on the back player, it's swapped in once it has a frame to show */
 	UFUNCTION() void RandomizeOverlay();
 
+	void CheckPreroll();
+
+	void SwapOverlay();
+
 	void StartRandomOverlayTimer();
 
 	UFUNCTION() void UpdateTime();
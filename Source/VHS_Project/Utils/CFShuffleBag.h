@@ -0,0 +1,80 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Utils/CF_RandomStream.h"
+
+/** Fisher-Yates over the whole array, same draw for the same stream state */
+template <typename T>
+inline void ShuffleArray(TArray<T>& inArray, FCF_RandomStream& Stream)
+{
+	const int32 lastIdx = inArray.Num() - 1;
+	for (int32 i = 0; i < lastIdx; ++i)
+	{
+		const int32 SwapIdx = Stream.RandRange(i, lastIdx);
+		if (i != SwapIdx)
+			inArray.Swap(i, SwapIdx);
+	}
+}
+
+/**
+ * Random sequence without repeats. Every item is drawn once per round and the first draw of a round is never the
+ * last draw of the previous one, so with two or more items the same item never comes out twice in a row.
+ * Each draw is a single swap inside the bag, nothing is allocated after Reset.
+ *
+ * The bag keeps its own copy of the items, UObject items must be kept alive by their owner.
+ */
+template <typename T>
+class TCF_ShuffleBag
+{
+public:
+
+	TCF_ShuffleBag() = default;
+
+	explicit TCF_ShuffleBag(const TArray<T>& inItems, const int32 Seed = 0)
+	{
+		Reset(inItems, Seed);
+	}
+
+	void Reset(const TArray<T>& inItems, const int32 Seed = 0)
+	{
+		Items = inItems;
+		Cursor = 0;
+		bHasDrawn = false;
+		Stream.Initialize(static_cast<uint32>(Seed));
+	}
+
+	void SetStream(const FCF_RandomStream& inStream) { Stream = inStream; }
+
+	const FCF_RandomStream& GetStream() const { return Stream; }
+
+	bool IsEmpty() const { return Items.IsEmpty(); }
+
+	int32 Num() const { return Items.Num(); }
+
+	const T& Draw()
+	{
+		check(!Items.IsEmpty());
+
+		if (Cursor >= Items.Num())
+			Cursor = 0;
+
+		// At the start of a round the previous draw sits in the last slot, leave it out
+		const int32 lastIdx = (Cursor == 0 && bHasDrawn && Items.Num() > 1) ? Items.Num() - 2 : Items.Num() - 1;
+
+		const int32 SwapIdx = Stream.RandRange(Cursor, lastIdx);
+		if (SwapIdx != Cursor)
+			Items.Swap(Cursor, SwapIdx);
+
+		bHasDrawn = true;
+		return Items[Cursor++];
+	}
+
+private:
+
+	TArray<T> Items;
+
+	int32 Cursor = 0;
+	bool bHasDrawn = false;
+
+	FCF_RandomStream Stream;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * PCG32 generator, 16 bytes of state and a multiply-add per draw. Every system owns its own stream so draws never
+ * contend on shared state, and the same seed and sequence give the same values on every platform.
+ */
+class FCF_RandomStream
+{
+public:
+
+	FCF_RandomStream() = default;
+
+	explicit FCF_RandomStream(const uint64 Seed, const uint64 Sequence = 0)
+	{
+		Initialize(Seed, Sequence);
+	}
+
+	/** Streams with the same seed and a different sequence are independent of each other */
+	void Initialize(const uint64 Seed, const uint64 Sequence = 0)
+	{
+		State = 0;
+		Increment = (Sequence << 1) | 1;
+		Next();
+		State += Seed;
+		Next();
+	}
+
+	uint32 Next()
+	{
+		const uint64 oldState = State;
+		State = oldState * 6364136223846793005ULL + Increment;
+
+		const uint32 xorShifted = static_cast<uint32>(((oldState >> 18) ^ oldState) >> 27);
+		const uint32 rotation = static_cast<uint32>(oldState >> 59);
+		return (xorShifted >> rotation) | (xorShifted << ((0u - rotation) & 31));
+	}
+
+	/** [0, 1) */
+	float FRand()
+	{
+		return (Next() >> 8) * (1.f / 16777216.f);
+	}
+
+	/** [Min, Max), same contract as FMath::FRandRange */
+	float FRandRange(const float Min, const float Max)
+	{
+		return Min + (Max - Min) * FRand();
+	}
+
+	/** [Min, Max], same contract as FRandomStream::RandRange */
+	int32 RandRange(const int32 Min, const int32 Max)
+	{
+		if (Max <= Min)
+			return Min;
+
+		// Multiply-shift instead of a modulo, the bias is below 2^-32 for any range used here
+		const uint64 range = static_cast<uint64>(static_cast<int64>(Max) - Min) + 1;
+		return Min + static_cast<int32>((Next() * range) >> 32);
+	}
+
+	bool RandBool()
+	{
+		return (Next() >> 31) != 0;
+	}
+
+	/** Fills Out with [Min, Max) in one pass, for systems drawing many values per frame */
+	void FillRange(TArrayView<float> Out, const float Min = 0.f, const float Max = 1.f)
+	{
+		const float scale = (Max - Min) * (1.f / 16777216.f);
+		for (float& value : Out)
+			value = Min + (Next() >> 8) * scale;
+	}
+
+	/** Fills Out with [Min, Max] in one pass */
+	void FillRange(TArrayView<int32> Out, const int32 Min, const int32 Max)
+	{
+		for (int32& value : Out)
+			value = RandRange(Min, Max);
+	}
+
+private:
+
+	uint64 State = 0x853c49e6748fea9bULL;
+	uint64 Increment = 0xda3e39cb94b95bdbULL;
+};
@@ -3,4 +3,8 @@
 #include "VHS_Project.h"
 #include "Modules/ModuleManager.h"
 
+DEFINE_LOG_CATEGORY(LogVHS);
+
+CSV_DEFINE_CATEGORY_MODULE(VHS_PROJECT_API, VHS, true);
+
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, VHS_Project, "VHS_Project" );
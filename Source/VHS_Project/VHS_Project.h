@@ -1,3 +1,20 @@
 #pragma once
 
-#include "CoreMinimal.h"
\ No newline at end of file
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogVHS, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("VHS"), STATGROUP_VHS, STATCAT_Advanced);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(VHS_PROJECT_API, VHS);
+
+/**
+ * Times the enclosing scope under one name in every profiler: the STAT_VHS_<Name> cycle counter (stat VHS),
+ * the VHS csv category and an Insights CPU event. The cycle stat is declared next to its use with DECLARE_CYCLE_STAT.
+ */
+#define VHS_SCOPE(Name) \
+	SCOPE_CYCLE_COUNTER(STAT_VHS_##Name); \
+	CSV_SCOPED_TIMING_STAT(VHS, Name); \
+	TRACE_CPUPROFILER_EVENT_SCOPE(VHS_##Name)